@@ -0,0 +1,61 @@
+#include "CellSpriteCache.h"
+#include "SequencerCell.h"
+
+void CellSpriteCache::drawCell(juce::Graphics& g, const juce::Rectangle<int>& bounds, const bool& isOn,
+    const bool& isLeftConnected, const bool& isRightConnected, const bool& isSelected, const bool& mouseIsOverCell)
+{
+    if (bounds.isEmpty())
+        return;
+
+    const auto scale{ g.getInternalContext().getPhysicalPixelScaleFactor() };
+    const auto variant{ isOn | isLeftConnected << 1 | isRightConnected << 2 | isSelected << 3 | mouseIsOverCell << 4 };
+
+    const SpriteKey key{ bounds.getWidth(), bounds.getHeight(), scale };
+    auto size{ sprites.find(key) };
+    if (size == sprites.end())
+    {
+        if (static_cast<int>(sprites.size()) >= maxSizes)
+            dropLeastRecentlyDrawnSize();
+
+        size = sprites.emplace(key, Sprites{}).first;
+    }
+
+    size->second.lastDrawn = ++drawsCount;
+
+    auto& sprite{ size->second.variants[variant] };
+    if (sprite.isNull())
+        sprite = renderSprite(bounds.getWidth(), bounds.getHeight(), scale, variant);
+
+    //the sprite is drawn opaque whatever opacity the caller is drawing at, without changing it for the caller
+    const juce::Graphics::ScopedSaveState savedState{ g };
+    g.setOpacity(1.f);
+    g.drawImage(sprite, bounds.toFloat());
+}
+
+void CellSpriteCache::dropLeastRecentlyDrawnSize()
+{
+    const auto leastRecentlyDrawn{ std::min_element(sprites.begin(), sprites.end(), [](const auto& first, const auto& second)
+        {
+            return first.second.lastDrawn < second.second.lastDrawn;
+        }) };
+
+    if (leastRecentlyDrawn != sprites.end())
+        sprites.erase(leastRecentlyDrawn);
+}
+
+juce::Image CellSpriteCache::renderSprite(const int& width, const int& height, const float& scale, const int& variant)
+{
+    juce::Image sprite{ juce::Image::ARGB,
+                        std::max(1, juce::roundToInt(width * scale)),
+                        std::max(1, juce::roundToInt(height * scale)),
+                        true };
+
+    juce::Graphics g{ sprite };
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    SequencerCell::paintCell(g, { width, height },
+        (variant & 1) ? SequencerCell::State::on : SequencerCell::State::off,
+        (variant & 1 << 1) != 0, (variant & 1 << 2) != 0, (variant & 1 << 3) != 0, (variant & 1 << 4) != 0);
+
+    return sprite;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <JuceHeader.h>
+
+//pre-rendered images of every visual variant of a cell, per cell size and display scale
+//there is one of these shared by every SequencerPanel and SequencerStrip through juce::SharedResourcePointer,
+//and their SequencerCells paint with their owner's, so painting a cell is a blit rather than rasterising its outline.
+//only the sprites of the maxSizes sizes drawn most recently are kept, so neither an editor being resized nor the tilt
+//morph changing the widths of the columns every frame throws away the sprites another editor is drawing with, or grows
+//the cache without bound
+class CellSpriteCache
+{
+public:
+    //draws a cell with these properties into bounds, rendering its sprite first if it isn't cached
+    void drawCell(juce::Graphics& g, const juce::Rectangle<int>& bounds, const bool& isOn,
+        const bool& isLeftConnected, const bool& isRightConnected, const bool& isSelected, const bool& mouseIsOverCell);
+
+    static constexpr int maxSizes{ 64 };
+
+private:
+    //one for each combination of on, left connected, right connected, selected and mouse over
+    static constexpr int numberOfVariants{ 1 << 5 };
+
+    using SpriteKey = std::tuple<int, int, float>;  //the width, height and scale factor the sprites are rendered at
+
+    //the sprites of one size, each rendered the first time it is drawn
+    struct Sprites
+    {
+        std::array<juce::Image, numberOfVariants> variants;
+        std::uint64_t lastDrawn{ 0 };               //the value of drawsCount when one of these was last drawn
+    };
+
+    std::map<SpriteKey, Sprites> sprites;           //at most maxSizes sizes
+    std::uint64_t drawsCount{ 0 };                  //incremented by every draw, so lastDrawn orders the sizes by when they were last drawn
+
+    //drops the sprites of the size drawn least recently, called to make room for a new size
+    void dropLeastRecentlyDrawnSize();
+
+    //renders a cell with the properties in variant at width by height logical pixels
+    static juce::Image renderSprite(const int& width, const int& height, const float& scale, const int& variant);
+};
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "ColumnLayout.h"
+
+void ColumnLayout::layOut(std::vector<int> newStartPositions, const int& newLength, const int& newTotalWidth)
+{
+    jassert(newLength > 0 && std::is_sorted(newStartPositions.begin(), newStartPositions.end()));
+
+    startPositions = std::move(newStartPositions);
+    length = newLength;
+    totalWidth = newTotalWidth;
+
+    offsets.resize(startPositions.size() + 1);
+
+    for (auto column{ 0 }; column != size(); ++column)
+        offsets[column] = startPositionToX(startPositions[column]);
+
+    offsets.back() = totalWidth;
+}
+
+void ColumnLayout::insertColumn(const int& column, const int& startPosition)
+{
+    jassert(column >= 0 && column <= size());
+
+    startPositions.insert(startPositions.begin() + column, startPosition);
+    offsets.insert(offsets.begin() + column, startPositionToX(startPosition));
+}
+
+void ColumnLayout::removeColumn(const int& column)
+{
+    jassert(column >= 0 && column < size());
+
+    startPositions.erase(startPositions.begin() + column);
+    offsets.erase(offsets.begin() + column);
+}
+
+void ColumnLayout::moveColumn(const int& column, const int& newStartPosition)
+{
+    jassert(column >= 0 && column < size());
+
+    startPositions[column] = newStartPosition;
+    offsets[column] = startPositionToX(newStartPosition);
+}
+
+std::optional<int> ColumnLayout::findSpan(const std::vector<int>& edges, const int& position)
+{
+    //the span containing position is the last one whose left edge is at or before it
+    const auto span{ static_cast<int>(std::upper_bound(edges.begin(), edges.end(), position) - edges.begin()) - 1 };
+
+    if (span < 0 || span >= static_cast<int>(edges.size()) - 1)
+        return std::nullopt;
+
+    return span;
+}
+
+std::pair<int, int> ColumnLayout::findSpansOverlapping(const std::vector<int>& edges, const int& from, const int& to)
+{
+    const auto first{ static_cast<int>(std::upper_bound(edges.begin(), edges.end(), from) - edges.begin()) - 1 };
+    const auto last{ static_cast<int>(std::lower_bound(edges.begin(), edges.end(), to) - edges.begin()) };
+
+    return { std::max(first, 0), std::min(last, static_cast<int>(edges.size()) - 1) };
+}
\ No newline at end of file
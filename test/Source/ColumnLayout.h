@@ -0,0 +1,57 @@
+#pragma once
+#include <JuceHeader.h>
+
+//the horizontal layout of a row of columns, used by SequencerPanel and SequencerStrip in place of juce::Grid
+//each column's left edge is its start position scaled to the total width and rounded, so edges don't depend on
+//each other and inserting, removing or moving a column only touches that column's edge. the edges are kept in
+//ascending order (the prefix sums of the column widths), so the column at an x is found by binary search
+class ColumnLayout
+{
+public:
+    //returns the number of columns
+    int size() const { return static_cast<int>(startPositions.size()); };
+
+    int getTotalWidth() const { return totalWidth; };
+
+    //returns the x of the left edge of each column followed by the right edge of the last
+    const std::vector<int>& getOffsets() const { return offsets; };
+
+    int getX(const int& column) const { return offsets[column]; };
+
+    int getWidth(const int& column) const { return offsets[column + 1] - offsets[column]; };
+
+    //lays out every column from scratch, newStartPositions must be ascending and in the range [0, newLength)
+    void layOut(std::vector<int> newStartPositions, const int& newLength, const int& newTotalWidth);
+
+    //inserts a column starting at startPosition at index column, the columns after it move along an index
+    void insertColumn(const int& column, const int& startPosition);
+
+    void removeColumn(const int& column);
+
+    //moves the left edge of column to newStartPosition, which must still be between its neighbours
+    void moveColumn(const int& column, const int& newStartPosition);
+
+    //returns the column containing x, or nullopt if x is outside the layout
+    std::optional<int> findColumn(const int& x) const { return findSpan(offsets, x); };
+
+    //returns the [first, last) columns overlapping [fromX, toX)
+    std::pair<int, int> findColumnsOverlapping(const int& fromX, const int& toX) const { return findSpansOverlapping(offsets, fromX, toX); };
+
+    //as findColumn but for any ascending edges, e.g. those of rows
+    static std::optional<int> findSpan(const std::vector<int>& edges, const int& position);
+
+    //as findColumnsOverlapping but for any ascending edges, e.g. those of rows
+    static std::pair<int, int> findSpansOverlapping(const std::vector<int>& edges, const int& from, const int& to);
+
+private:
+    std::vector<int> startPositions;    //the start position of each column, in whatever whole units the owner uses (e.g. ticks)
+    int length{ 1 };                    //the start position the right edge of the last column corresponds to
+    int totalWidth{ 0 };                //the number of pixels length is laid out across
+    std::vector<int> offsets{ 0 };      //size() + 1 edges, the last of which is always totalWidth
+
+    //startPosition / length * totalWidth rounded to the nearest pixel, in exact integer arithmetic
+    int startPositionToX(const int& startPosition) const
+    {
+        return static_cast<int>((2 * static_cast<std::int64_t>(startPosition) * totalWidth + length) / (2 * static_cast<std::int64_t>(length)));
+    };
+};
\ No newline at end of file
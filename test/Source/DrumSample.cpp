@@ -0,0 +1,87 @@
+#include "DrumSample.h"
+
+DrumSample::DrumSample(const juce::AudioBuffer<float>& source, const double& sourceSampleRate, const double& playbackSampleRate)
+    : speedRatio(sourceSampleRate / playbackSampleRate),
+      length(resampledLength(source.getNumSamples(), speedRatio)),
+      attack(juce::jmin(source.getNumChannels(), maxChannels), length)
+{
+    jassert(sourceSampleRate > 0.0 && playbackSampleRate > 0.0);
+
+    interpolate(source, 0, speedRatio, 0, attack, 0, length);
+}
+
+DrumSample::DrumSample(std::shared_ptr<juce::AudioFormatReader> sourceReader, const double& playbackSampleRate)
+    : reader(std::move(sourceReader)),
+      speedRatio(reader->sampleRate / playbackSampleRate),
+      length(resampledLength(reader->lengthInSamples, speedRatio)),
+      attack(juce::jmin(static_cast<int>(reader->numChannels), maxChannels), juce::jmin(length, attackFrames))
+{
+    jassert(reader->sampleRate > 0.0 && playbackSampleRate > 0.0);
+
+    juce::AudioBuffer<float> scratch;
+    readFrames(0, scratch, attack, 0, attack.getNumSamples());
+}
+
+void DrumSample::readFrames(const int& firstFrame, juce::AudioBuffer<float>& scratch, juce::AudioBuffer<float>& destination,
+                            const int& destinationStart, const int& numFrames) const
+{
+    jassert(firstFrame >= 0 && firstFrame + numFrames <= length);
+
+    if (numFrames <= 0)
+        return;
+
+    if (reader == nullptr)
+    {
+        for (auto channel{ 0 }; channel != getNumChannels(); ++channel)
+            destination.copyFrom(channel, destinationStart, attack, channel, firstFrame, numFrames);
+
+        return;
+    }
+
+    //the source frames the frames are interpolated from, including the one after the last for its interpolation
+    const auto sourceStart{ static_cast<juce::int64>(firstFrame * speedRatio) };
+    const auto sourceEnd{ juce::jmin(reader->lengthInSamples, static_cast<juce::int64>((firstFrame + numFrames - 1) * speedRatio) + 2) };
+    const auto sourceLength{ static_cast<int>(sourceEnd - sourceStart) };
+
+    scratch.setSize(getNumChannels(), sourceLength, false, false, true);
+    reader->read(&scratch, 0, sourceLength, sourceStart, true, true);
+
+    interpolate(scratch, sourceStart, speedRatio, firstFrame, destination, destinationStart, numFrames);
+}
+
+int DrumSample::resampledLength(const juce::int64& sourceLength, const double& speedRatio)
+{
+    //the last frame is the last one which doesn't start past the last source frame
+    return sourceLength <= 0 ? 0 : static_cast<int>(static_cast<double>(sourceLength - 1) / speedRatio) + 1;
+}
+
+void DrumSample::interpolate(const juce::AudioBuffer<float>& source, const juce::int64& sourceStart, const double& speedRatio,
+                             const int& firstFrame, juce::AudioBuffer<float>& destination, const int& destinationStart, const int& numFrames)
+{
+    const auto sourceLength{ source.getNumSamples() };
+    const auto numChannels{ juce::jmin(source.getNumChannels(), destination.getNumChannels()) };
+
+    if (speedRatio == 1.0)
+    {
+        for (auto channel{ 0 }; channel != numChannels; ++channel)
+            destination.copyFrom(channel, destinationStart, source, channel, static_cast<int>(firstFrame - sourceStart), numFrames);
+
+        return;
+    }
+
+    for (auto channel{ 0 }; channel != numChannels; ++channel)
+    {
+        const auto* input{ source.getReadPointer(channel) };
+        auto* output{ destination.getWritePointer(channel, destinationStart) };
+
+        for (auto frame{ 0 }; frame != numFrames; ++frame)
+        {
+            const auto sourcePosition{ (firstFrame + frame) * speedRatio - static_cast<double>(sourceStart) };
+            const auto index{ static_cast<int>(sourcePosition) };
+            const auto fraction{ static_cast<float>(sourcePosition - index) };
+            const auto next{ juce::jmin(index + 1, sourceLength - 1) };
+
+            output[frame] = input[index] + fraction * (input[next] - input[index]);
+        }
+    }
+}
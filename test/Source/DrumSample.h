@@ -0,0 +1,51 @@
+#pragma once
+#include <JuceHeader.h>
+
+//a sample of DrumSampler at the playback rate. a sample is either held entirely in memory, or only its first attackFrames
+//frames are, and the rest (the tail) is read on demand from a juce::MemoryMappedAudioFormatReader by SampleStreamer, so a kit
+//of any size costs little more memory than its attacks and loads without decoding whole files. samples recorded at another
+//rate are resampled by linear interpolation as they are read, so the attack and the tail join up exactly.
+//immutable once made, so any thread can read one
+class DrumSample
+{
+public:
+    //a sample held entirely in memory, made from source recorded at sourceSampleRate
+    DrumSample(const juce::AudioBuffer<float>& source, const double& sourceSampleRate, const double& playbackSampleRate);
+
+    //a sample read from sourceReader, whose tail is streamed if it is longer than attackFrames. sourceReader must be able to
+    //read any part of its file without blocking on a lock, e.g. a mapped juce::MemoryMappedAudioFormatReader
+    DrumSample(std::shared_ptr<juce::AudioFormatReader> sourceReader, const double& playbackSampleRate);
+
+    int getNumChannels() const { return attack.getNumChannels(); };
+
+    //returns the length of the whole sample in frames at the playback rate
+    int getLength() const { return length; };
+
+    //returns the frames held in memory, the whole sample unless isStreamed()
+    const juce::AudioBuffer<float>& getAttack() const { return attack; };
+
+    //returns true if the frames after getAttack() have to be read with readFrames()
+    bool isStreamed() const { return reader != nullptr && attack.getNumSamples() < length; };
+
+    //reads numFrames frames of the sample from firstFrame into destination from destinationStart, scratch is reused between
+    //calls so reading doesn't allocate once it is big enough. not for the audio thread, as reading may wait on the disk
+    void readFrames(const int& firstFrame, juce::AudioBuffer<float>& scratch, juce::AudioBuffer<float>& destination,
+                    const int& destinationStart, const int& numFrames) const;
+
+    static constexpr int attackFrames{ 16384 };    //the frames of a streamed sample held in memory, which cover it while its stream fills
+    static constexpr int maxChannels{ 2 };         //sources with more channels than this only have their first ones read
+
+private:
+    std::shared_ptr<juce::AudioFormatReader> reader;    //the source of a sample read from a file, nullptr if it was made in memory
+    double speedRatio{ 1.0 };                           //source frames per frame at the playback rate
+    int length{ 0 };
+    juce::AudioBuffer<float> attack;
+
+    //returns the number of frames at speedRatio which sourceLength frames of source make
+    static int resampledLength(const juce::int64& sourceLength, const double& speedRatio);
+
+    //writes numFrames frames from firstFrame, resampled at speedRatio from source (whose first frame is sourceStart),
+    //into destination from destinationStart
+    static void interpolate(const juce::AudioBuffer<float>& source, const juce::int64& sourceStart, const double& speedRatio,
+                            const int& firstFrame, juce::AudioBuffer<float>& destination, const int& destinationStart, const int& numFrames);
+};
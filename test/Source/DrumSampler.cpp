@@ -0,0 +1,302 @@
+#include "DrumSampler.h"
+
+DrumSampler::DrumSampler()
+    : currentKit(new Kit)
+{
+    formatManager.registerBasicFormats();
+}
+
+DrumSampler::~DrumSampler()
+{
+    //the audio thread has stopped by now, and once the streaming thread has too everything can be freed here
+    streamer.shutDown();
+    freeRetiredKits();
+    delete pendingKit.exchange(nullptr);
+    delete currentKit;
+}
+
+void DrumSampler::prepare(const double& newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+
+    if (newSampleRate != sampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        for (auto row{ 0 }; row != CONSTANTS::MIDI_PITCHES_SIZE; ++row)
+            if (sources[row] != nullptr)
+                resampledSamples[row] = makeSample(*sources[row], sampleRate);
+
+        publishKit();
+    }
+
+    stopAllVoices();
+}
+
+void DrumSampler::setSample(const int& row, const juce::AudioBuffer<float>& sample, const double& recordedSampleRate)
+{
+    jassert(row >= 0 && row < CONSTANTS::MIDI_PITCHES_SIZE);
+    jassert(recordedSampleRate > 0.0);
+
+    if (sample.getNumSamples() == 0 || sample.getNumChannels() == 0)
+    {
+        clearSample(row);
+        return;
+    }
+
+    auto source{ std::make_unique<Source>() };
+    source->sample.makeCopyOf(sample);
+    source->sampleRate = recordedSampleRate;
+
+    resampledSamples[row] = makeSample(*source, sampleRate);
+    sources[row] = std::move(source);
+
+    publishKit();
+}
+
+bool DrumSampler::loadSample(const int& row, const juce::File& file)
+{
+    jassert(row >= 0 && row < CONSTANTS::MIDI_PITCHES_SIZE);
+
+    //mapping the file only reserves address space, its pages are read by the disk cache as the sample is played
+    if (auto* format{ formatManager.findFormatForFileExtension(file.getFileExtension()) })
+    {
+        std::shared_ptr<juce::MemoryMappedAudioFormatReader> reader{ format->createMemoryMappedReader(file) };
+
+        if (reader != nullptr && reader->mapEntireFile() && reader->lengthInSamples > 0
+            && reader->lengthInSamples <= std::numeric_limits<int>::max())
+        {
+            auto source{ std::make_unique<Source>() };
+            source->sampleRate = reader->sampleRate;
+            source->reader = std::move(reader);
+
+            resampledSamples[row] = makeSample(*source, sampleRate);
+            sources[row] = std::move(source);
+
+            publishKit();
+            return true;
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(file) };
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->lengthInSamples > std::numeric_limits<int>::max())
+        return false;
+
+    const auto length{ static_cast<int>(reader->lengthInSamples) };
+    juce::AudioBuffer<float> sample(juce::jmin(static_cast<int>(reader->numChannels), DrumSample::maxChannels), length);
+
+    if (!reader->read(&sample, 0, length, 0, true, true))
+        return false;
+
+    setSample(row, sample, reader->sampleRate);
+    return true;
+}
+
+void DrumSampler::clearSample(const int& row)
+{
+    sources[row].reset();
+    resampledSamples[row].reset();
+
+    publishKit();
+}
+
+DrumSampler::Samples DrumSampler::getSamples(const double& newSampleRate) const
+{
+    if (newSampleRate == sampleRate)
+        return resampledSamples;
+
+    Samples samples;
+
+    for (auto row{ 0 }; row != CONSTANTS::MIDI_PITCHES_SIZE; ++row)
+        if (sources[row] != nullptr)
+            samples[row] = makeSample(*sources[row], newSampleRate);
+
+    return samples;
+}
+
+void DrumSampler::renderNextBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples)
+{
+    acquireKit();
+
+    const auto endSample{ startSample + numSamples };
+    auto sample{ startSample };
+
+    //the voices are rendered up to each note-on, which then starts its voice on the sample it falls on
+    for (const auto metadata : midiMessages)
+    {
+        if (metadata.samplePosition < startSample || metadata.samplePosition >= endSample)
+            continue;
+
+        const auto message{ metadata.getMessage() };
+        if (!message.isNoteOn())
+            continue;
+
+        renderVoices(buffer, sample, metadata.samplePosition - sample);
+        sample = metadata.samplePosition;
+
+        startVoice(message.getNoteNumber(), message.getFloatVelocity());
+    }
+
+    renderVoices(buffer, sample, endSample - sample);
+}
+
+void DrumSampler::stopAllVoices()
+{
+    for (auto& voice : voices)
+        if (voice.sample != nullptr)
+            stopVoice(voice);
+}
+
+void DrumSampler::freeRetiredKits()
+{
+    int start1, size1, start2, size2;
+    retiredKitsFifo.prepareToRead(retiredKitsFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (auto index{ start1 }; index != start1 + size1; ++index)
+        delete std::exchange(retiredKits[static_cast<size_t>(index)], nullptr);
+
+    for (auto index{ start2 }; index != start2 + size2; ++index)
+        delete std::exchange(retiredKits[static_cast<size_t>(index)], nullptr);
+
+    retiredKitsFifo.finishedRead(size1 + size2);
+}
+
+void DrumSampler::publishKit()
+{
+    auto kit{ std::make_unique<Kit>() };
+    kit->samples = resampledSamples;
+
+    //if the audio thread never picked up the last published kit it never will, so it is safe to free it
+    delete pendingKit.exchange(kit.release(), std::memory_order_acq_rel);
+}
+
+void DrumSampler::acquireKit()
+{
+    //the kit being let go of has to be queued to be freed, so if the queue is full the new kit waits until the next block
+    if (retiredKitsFifo.getFreeSpace() == 0)
+        return;
+
+    auto* newKit{ pendingKit.exchange(nullptr, std::memory_order_acq_rel) };
+    if (newKit == nullptr)
+        return;
+
+    //the old kit keeps its samples alive until the message thread frees it, so only voices whose sample won't be in the new kit stop
+    for (auto& voice : voices)
+        if (voice.sample != nullptr && voice.sample != newKit->samples[voice.row].get())
+            stopVoice(voice);
+
+    int start1, size1, start2, size2;
+    retiredKitsFifo.prepareToWrite(1, start1, size1, start2, size2);
+    jassert(size1 == 1);
+    retiredKits[static_cast<size_t>(start1)] = currentKit;
+    retiredKitsFifo.finishedWrite(1);
+
+    currentKit = newKit;
+}
+
+void DrumSampler::startVoice(const int& row, const float& gain)
+{
+    const auto* sample{ currentKit->samples[row].get() };
+    if (sample == nullptr)
+        return;
+
+    //a free voice if there is one, otherwise the oldest
+    auto* chosenVoice{ &voices.front() };
+
+    for (auto& voice : voices)
+    {
+        if (voice.sample == nullptr)
+        {
+            chosenVoice = &voice;
+            break;
+        }
+
+        if (voicesStarted - voice.startedAt > voicesStarted - chosenVoice->startedAt)
+            chosenVoice = &voice;
+    }
+
+    if (chosenVoice->sample != nullptr)
+        stopVoice(*chosenVoice);
+
+    chosenVoice->sample = sample;
+    chosenVoice->row = row;
+    chosenVoice->position = 0;
+    chosenVoice->gain = gain;
+    chosenVoice->startedAt = voicesStarted++;
+
+    //the stream starts filling now, while the voice plays the attack. if every stream is busy only the attack is played
+    if (sample->isStreamed())
+        chosenVoice->stream = streamer.startStream(*sample, sample->getAttack().getNumSamples());
+}
+
+void DrumSampler::stopVoice(Voice& voice)
+{
+    if (voice.stream >= 0)
+        streamer.releaseStream(voice.stream);
+
+    voice.sample = nullptr;
+    voice.stream = -1;
+}
+
+void DrumSampler::renderVoices(juce::AudioBuffer<float>& buffer, const int& startSample, const int& numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    for (auto& voice : voices)
+    {
+        if (voice.sample == nullptr)
+            continue;
+
+        const auto& sample{ *voice.sample };
+        const auto& attack{ sample.getAttack() };
+        auto start{ startSample };
+        auto remaining{ numSamples };
+
+        //the attack is mixed straight from memory. a mono sample is played in every channel, otherwise each channel plays
+        //its own, as far as the sample has channels
+        if (voice.position < attack.getNumSamples())
+        {
+            const auto length{ juce::jmin(remaining, attack.getNumSamples() - voice.position) };
+
+            for (auto channel{ 0 }; channel != buffer.getNumChannels(); ++channel)
+                juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(channel, start),
+                                                             attack.getReadPointer(juce::jmin(channel, attack.getNumChannels() - 1), voice.position),
+                                                             voice.gain, length);
+
+            voice.position += length;
+            start += length;
+            remaining -= length;
+        }
+
+        //then the tail from its stream. if the stream has fallen behind, or there never was one, the voice is cut short
+        //rather than play frames late
+        if (remaining > 0 && voice.position < sample.getLength())
+        {
+            const auto ready{ voice.stream >= 0 ? streamer.getNumReady(voice.stream) : 0 };
+            const auto length{ juce::jmin(remaining, ready, sample.getLength() - voice.position) };
+
+            if (length > 0)
+                streamer.mixFrames(voice.stream, buffer, start, length, voice.gain);
+
+            voice.position += length;
+
+            if (length < remaining && voice.position < sample.getLength())
+            {
+                stopVoice(voice);
+                continue;
+            }
+        }
+
+        if (voice.position == sample.getLength())
+            stopVoice(voice);
+    }
+}
+
+std::shared_ptr<const DrumSample> DrumSampler::makeSample(const Source& source, const double& newSampleRate)
+{
+    if (source.reader != nullptr)
+        return std::make_shared<const DrumSample>(source.reader, newSampleRate);
+
+    return std::make_shared<const DrumSample>(source.sample, source.sampleRate, newSampleRate);
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <JuceHeader.h>
+#include "DrumSample.h"
+#include "SampleStreamer.h"
+#include "Globals.h"
+
+//a one-shot drum sampler voicing the notes PatternPlayer writes into the MidiBuffer, so the pattern can be heard without
+//routing its MIDI through the host. each row (pitch) can be given a sample, which every note-on in that row plays from start
+//to end; note-offs are ignored, as drums ring out. voices come from a fixed pool, stealing the oldest when it is full, and are
+//mixed with vector operations straight from the sample into the output, since samples are resampled to the playback rate
+//when they are assigned. samples loaded from files which can be memory mapped only keep their attacks in memory, and the
+//rest is streamed (see DrumSample and SampleStreamer). samples are handed to the audio thread the same way as patterns
+//(see PatternExchange), so renderNextBlock() never allocates, frees, locks or reads from the disk
+class DrumSampler
+{
+public:
+    //a sample (or nullptr) for every row
+    using Samples = std::array<std::shared_ptr<const DrumSample>, CONSTANTS::MIDI_PITCHES_SIZE>;
+
+    DrumSampler();
+
+    ~DrumSampler();
+
+    //must be called while the audio thread is stopped (e.g. from prepareToPlay()) with the sample rate playback will run
+    //at, resamples every assigned sample to it and stops every voice
+    void prepare(const double& newSampleRate);
+
+    //message thread only: assigns sample, recorded at recordedSampleRate, to row, from the next block on. voices playing
+    //the sample row had before are stopped
+    void setSample(const int& row, const juce::AudioBuffer<float>& sample, const double& recordedSampleRate);
+
+    //message thread only: opens file (in any format juce::AudioFormatManager::registerBasicFormats() knows) and assigns
+    //it to row as above, returns false if file can't be read. WAV and AIFF files are memory mapped and only their attacks
+    //are read now, other formats are decoded whole
+    bool loadSample(const int& row, const juce::File& file);
+
+    //message thread only: removes the sample of row
+    void clearSample(const int& row);
+
+    //message thread only: returns true if row has a sample
+    bool hasSample(const int& row) const { return resampledSamples[row] != nullptr; };
+
+    //message thread only: returns the samples of every row at newSampleRate, e.g. for rendering offline. the samples already
+    //at that rate are shared rather than made again
+    Samples getSamples(const double& newSampleRate) const;
+
+    //audio thread only: adds numSamples samples of every voice into buffer from startSample, starting voices for the
+    //note-ons in midiMessages at the samples they fall on
+    void renderNextBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples);
+
+    //audio thread only: stops every voice straight away
+    void stopAllVoices();
+
+    static constexpr int maxVoices{ 64 };          //the number of notes which can ring at once before the oldest is stolen
+
+private:
+    //the samples of every row at the playback rate, immutable once published. kits share the samples of unchanged rows,
+    //so publishing a kit only copies pointers
+    struct Kit
+    {
+        Samples samples;
+    };
+
+    //a sample as it was assigned, kept so it can be resampled again if the playback rate changes
+    struct Source
+    {
+        juce::AudioBuffer<float> sample;                    //the sample if it was assigned from memory or decoded whole
+        double sampleRate{ 0.0 };
+        std::shared_ptr<juce::AudioFormatReader> reader;    //otherwise the memory mapped reader its frames are read from
+    };
+
+    struct Voice
+    {
+        const DrumSample* sample{ nullptr };    //the sample being played, nullptr if the voice is free
+        int row{ 0 };                       //the row the sample belongs to
+        int position{ 0 };                  //the index of the next frame of sample to be played
+        int stream{ -1 };                   //the stream of the sample's tail, -1 if it has none
+        float gain{ 0.f };                  //taken from the note-on's velocity
+        std::uint32_t startedAt{ 0 };       //when the voice was started, counted in voices started, so the oldest can be stolen
+    };
+
+    static constexpr int retiredKitsCapacity{ 8 };
+
+    double sampleRate{ 44100.0 };
+    std::array<std::unique_ptr<Source>, CONSTANTS::MIDI_PITCHES_SIZE> sources;                   //message thread only
+    Samples resampledSamples;                                                                    //message thread only, the samples of the next kit
+    juce::AudioFormatManager formatManager;                                                      //message thread only
+
+    std::atomic<Kit*> pendingKit{ nullptr };                            //published but not yet picked up by the audio thread
+    Kit* currentKit;                                                    //the kit the audio thread is playing
+    std::array<Kit*, retiredKitsCapacity> retiredKits{};                //the kits the audio thread has let go of, waiting to be freed
+    juce::AbstractFifo retiredKitsFifo{ retiredKitsCapacity };
+
+    std::array<Voice, maxVoices> voices;                                //audio thread only
+    std::uint32_t voicesStarted{ 0 };
+
+    //declared last so the streaming thread stops before anything it reads is freed
+    SampleStreamer streamer{ [this] { freeRetiredKits(); } };
+
+    //streaming thread only (or once it has stopped): frees the kits the audio thread has finished with. the streaming thread
+    //is the only other thread to read a kit's samples, so it frees them once it has seen their streams released
+    void freeRetiredKits();
+
+    //message thread only: publishes a kit of resampledSamples, freeing the last one if the audio thread never picked it up
+    void publishKit();
+
+    //audio thread only: picks up the most recently published kit, stopping the voices whose row's sample changed
+    void acquireKit();
+
+    //starts a voice playing row's sample at gain, stealing the oldest voice if every one is busy
+    void startVoice(const int& row, const float& gain);
+
+    //frees voice and releases its stream
+    void stopVoice(Voice& voice);
+
+    //adds numSamples samples of every voice into buffer from startSample
+    void renderVoices(juce::AudioBuffer<float>& buffer, const int& startSample, const int& numSamples);
+
+    //returns source at newSampleRate
+    static std::shared_ptr<const DrumSample> makeSample(const Source& source, const double& newSampleRate);
+
+    JUCE_DECLARE_NON_COPYABLE(DrumSampler)
+};
@@ -6,7 +6,12 @@ namespace CONSTANTS
     constexpr int WINDOW_HEIGHT{ 600 };
     constexpr int WINDOW_WIDTH{ 1000 };
     constexpr int MIDI_PITCHES_SIZE{ 128 };
-    constexpr int MAX_REPEATS{ 32 };
+    constexpr int MAX_REPEATS{ 32 };                //the most times a pattern's base columns can be repeated, and be saved and restored with
+    constexpr double DEFAULT_BEATS_PER_MINUTE{ 120.0 };
+    constexpr double BEATS_PER_REPEAT{ 4.0 };       //a repeat of the base columns lasts a bar of 4/4
+    constexpr int TICKS_PER_REPEAT{ 26880 };        //column start positions are whole ticks, this divides by every n up to 8 so evenly spaced columns are exact
+    constexpr int ALPHA_GRID_COLUMNS{ 3 };          //the columns of the alpha strip, the grid the tilt panel's columns are on at a tilt of 0
+    constexpr int BETA_GRID_COLUMNS{ 4 };           //the columns of the beta strip, the grid the tilt panel's columns are on at a tilt of 1
     const std::map<int, juce::String> PITCH_NAME_MAP
     {
         {0,   "C-2" }, {1,   "C#-2"}, {2,   "D-2" }, {3,   "D#-2"},
@@ -0,0 +1,171 @@
+#include "PatternBouncer.h"
+#include "PatternPlayer.h"
+
+PatternBouncer::PatternBouncer(const int& numberOfThreads)
+    : threadPool(juce::jmax(1, numberOfThreads))
+{
+}
+
+PatternBouncer::Bounce PatternBouncer::render(const PatternModel& pattern, const TiltMorph& morph, const Settings& settings, const DrumSampler::Samples& samples)
+{
+    jassert(settings.bars > 0 && settings.beatsPerMinute > 0.0 && settings.quarterNotesPerRepeat > 0.0 && settings.sampleRate > 0.0);
+
+    const auto schedule{ compiler.compile(pattern, morph) };
+    const auto& events{ schedule->getEvents() };
+
+    //the events of each row, in the order they are played
+    std::array<std::vector<int>, CONSTANTS::MIDI_PITCHES_SIZE> rowEvents;
+    for (auto index{ 0 }; index != static_cast<int>(events.size()); ++index)
+        rowEvents[events[static_cast<size_t>(index)].pitch].push_back(index);
+
+    std::array<RowBounce, CONSTANTS::MIDI_PITCHES_SIZE> rowBounces;
+    const auto rowsToRender{ static_cast<int>(std::count_if(rowEvents.begin(), rowEvents.end(), [](const auto& row) { return !row.empty(); })) };
+    std::atomic<int> unfinishedRows{ rowsToRender };
+    juce::WaitableEvent allRowsFinished;
+
+    for (auto row{ 0 }; row != CONSTANTS::MIDI_PITCHES_SIZE; ++row)
+    {
+        if (rowEvents[row].empty())
+            continue;
+
+        threadPool.addJob([&, row]
+            {
+                renderRow(*schedule, rowEvents[row], samples[row].get(), settings, rowBounces[row]);
+
+                if (--unfinishedRows == 0)
+                    allRowsFinished.signal();
+            });
+    }
+
+    if (rowsToRender > 0)
+        allRowsFinished.wait();
+
+    Bounce bounce;
+    bounce.lengthInMidiTicks = settings.bars * CONSTANTS::TICKS_PER_REPEAT * settings.quarterNotesPerRepeat / CONSTANTS::BEATS_PER_REPEAT;
+
+    auto audioLength{ 0 };
+    for (const auto& rowBounce : rowBounces)
+        audioLength = juce::jmax(audioLength, rowBounce.audio.getNumSamples());
+
+    if (audioLength > 0)
+    {
+        bounce.audio.setSize(2, audioLength);
+        bounce.audio.clear();
+    }
+
+    for (const auto& rowBounce : rowBounces)
+    {
+        bounce.midi.addSequence(rowBounce.midi, 0.0);
+
+        //a mono sample is mixed into both channels
+        const auto& rowAudio{ rowBounce.audio };
+        for (auto channel{ 0 }; rowAudio.getNumSamples() > 0 && channel != bounce.audio.getNumChannels(); ++channel)
+            bounce.audio.addFrom(channel, 0, rowAudio, juce::jmin(channel, rowAudio.getNumChannels() - 1), 0, rowAudio.getNumSamples());
+    }
+
+    bounce.midi.updateMatchedPairs();
+
+    return bounce;
+}
+
+bool PatternBouncer::writeMidiFile(const Bounce& bounce, const double& beatsPerMinute, const juce::File& file)
+{
+    juce::MidiMessageSequence track;
+    track.addEvent(juce::MidiMessage::tempoMetaEvent(juce::roundToInt(60000000.0 / beatsPerMinute)), 0.0);
+    track.addSequence(bounce.midi, 0.0);
+    track.addEvent(juce::MidiMessage::endOfTrack(), bounce.lengthInMidiTicks);
+    track.updateMatchedPairs();
+
+    juce::MidiFile midiFile;
+    midiFile.setTicksPerQuarterNote(midiTicksPerQuarterNote);
+    midiFile.addTrack(track);
+
+    juce::FileOutputStream stream(file);
+    if (!stream.openedOk())
+        return false;
+
+    stream.setPosition(0);
+    stream.truncate();
+
+    return midiFile.writeTo(stream);
+}
+
+bool PatternBouncer::writeWavFile(const Bounce& bounce, const double& sampleRate, const juce::File& file)
+{
+    std::unique_ptr<juce::FileOutputStream> stream{ file.createOutputStream() };
+    if (stream == nullptr)
+        return false;
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer{ wavFormat.createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0) };
+    if (writer == nullptr)
+        return false;
+
+    //the writer owns the stream now
+    stream.release();
+
+    return writer->writeFromAudioSampleBuffer(bounce.audio, 0, bounce.audio.getNumSamples());
+}
+
+void PatternBouncer::renderRow(const PatternSchedule& schedule, const std::vector<int>& eventIndices, const DrumSample* sample,
+                               const Settings& settings, RowBounce& rowBounce)
+{
+    const auto& events{ schedule.getEvents() };
+    const auto patternLength{ static_cast<double>(schedule.getLength()) };
+    const auto renderLength{ static_cast<double>(settings.bars) * CONSTANTS::TICKS_PER_REPEAT };
+    const auto midiTicksPerTick{ settings.quarterNotesPerRepeat / CONSTANTS::BEATS_PER_REPEAT };
+    const auto framesPerTick{ settings.sampleRate * 60.0 / settings.beatsPerMinute * settings.quarterNotesPerRepeat / CONSTANTS::TICKS_PER_REPEAT };
+    const auto pitch{ events[static_cast<size_t>(eventIndices.front())].pitch };
+
+    std::vector<int> noteOnFrames;
+    auto isSounding{ false };
+
+    for (auto loopStart{ 0.0 }; loopStart < renderLength; loopStart += patternLength)
+    {
+        for (const auto& index : eventIndices)
+        {
+            const auto position{ loopStart + schedule.getEventPosition(index, settings.tilt) };
+            if (position >= renderLength)
+                break;
+
+            //as in PatternPlayer::playEvent(), so the render matches playback
+            if (isSounding)
+            {
+                rowBounce.midi.addEvent(juce::MidiMessage::noteOff(PatternPlayer::midiChannel, pitch), position * midiTicksPerTick);
+                isSounding = false;
+            }
+
+            if (events[static_cast<size_t>(index)].isNoteOn)
+            {
+                rowBounce.midi.addEvent(juce::MidiMessage::noteOn(PatternPlayer::midiChannel, pitch, PatternPlayer::noteVelocity), position * midiTicksPerTick);
+                isSounding = true;
+
+                //the first frame at or after the event, as PatternPlayer places events
+                noteOnFrames.push_back(static_cast<int>(std::ceil(position * framesPerTick - 1.0e-6)));
+            }
+        }
+    }
+
+    if (isSounding)
+        rowBounce.midi.addEvent(juce::MidiMessage::noteOff(PatternPlayer::midiChannel, pitch), renderLength * midiTicksPerTick);
+
+    if (sample == nullptr || noteOnFrames.empty())
+        return;
+
+    //the sample is read once, then every note adds all of it in from its frame
+    juce::AudioBuffer<float> frames(sample->getNumChannels(), sample->getLength());
+    juce::AudioBuffer<float> scratch;
+    sample->readFrames(0, scratch, frames, 0, sample->getLength());
+
+    rowBounce.audio.setSize(frames.getNumChannels(), noteOnFrames.back() + frames.getNumSamples());
+    rowBounce.audio.clear();
+
+    const auto gain{ PatternPlayer::noteVelocity / 127.f };
+
+    for (const auto& frame : noteOnFrames)
+        for (auto channel{ 0 }; channel != frames.getNumChannels(); ++channel)
+            rowBounce.audio.addFrom(channel, frame, frames, channel, 0, frames.getNumSamples(), gain);
+}
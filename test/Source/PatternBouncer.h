@@ -0,0 +1,65 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PatternModel.h"
+#include "PatternCompiler.h"
+#include "PatternSchedule.h"
+#include "TiltMorph.h"
+#include "DrumSampler.h"
+#include "Globals.h"
+
+//renders a pattern offline, without a host or an audio device, to MIDI and (given the drum sampler's samples) to audio, as
+//fast as the CPU allows. rows are independent of each other, so each is rendered by its own job on a juce::ThreadPool and
+//the results are merged. unlike DrumSampler, every note rings out in full, since there is no voice pool to run out of.
+//message thread (or any one thread) only
+class PatternBouncer
+{
+public:
+    struct Settings
+    {
+        int bars{ 1 };                                                      //how long to render, a bar being a repeat of the base columns
+        double beatsPerMinute{ CONSTANTS::DEFAULT_BEATS_PER_MINUTE };
+        double quarterNotesPerRepeat{ CONSTANTS::BEATS_PER_REPEAT };
+        float tilt{ 0.f };                                                  //the tilt the columns of a morphed pattern are played at
+        double sampleRate{ 48000.0 };                                       //the sample rate of the audio and of the samples it is rendered from
+    };
+
+    //a rendered pattern
+    struct Bounce
+    {
+        juce::MidiMessageSequence midi;     //timestamped in midiTicksPerQuarterNote, every note is ended by the end of the render
+        juce::AudioBuffer<float> audio;     //stereo, long enough for the last note to ring out, empty if there were no samples
+        double lengthInMidiTicks{ 0.0 };    //where the render ends, not counting notes ringing out
+    };
+
+    explicit PatternBouncer(const int& numberOfThreads = juce::SystemStats::getNumCpus());
+
+    //renders pattern morphed by morph with settings, voicing the rows which have samples in samples (which must be at
+    //settings.sampleRate, see DrumSampler::getSamples())
+    Bounce render(const PatternModel& pattern, const TiltMorph& morph, const Settings& settings, const DrumSampler::Samples& samples = {});
+
+    //writes bounce's MIDI to file as a standard MIDI file with a tempo of beatsPerMinute, returns false if it can't be written
+    static bool writeMidiFile(const Bounce& bounce, const double& beatsPerMinute, const juce::File& file);
+
+    //writes bounce's audio to file as a 24 bit WAV file, returns false if it can't be written
+    static bool writeWavFile(const Bounce& bounce, const double& sampleRate, const juce::File& file);
+
+    //a tick of the MIDI is a tick of a pattern whose repeats last 4 quarter notes, so positions in a 4/4 pattern are exact
+    static constexpr int midiTicksPerQuarterNote{ static_cast<int>(CONSTANTS::TICKS_PER_REPEAT / CONSTANTS::BEATS_PER_REPEAT) };
+
+private:
+    juce::ThreadPool threadPool;
+    PatternCompiler compiler;
+
+    //what a row's job renders
+    struct RowBounce
+    {
+        juce::MidiMessageSequence midi;
+        juce::AudioBuffer<float> audio;
+    };
+
+    //renders the events at eventIndices (all in the same row) of schedule into rowBounce, voicing them with sample if it isn't nullptr
+    static void renderRow(const PatternSchedule& schedule, const std::vector<int>& eventIndices, const DrumSample* sample,
+                          const Settings& settings, RowBounce& rowBounce);
+
+    JUCE_DECLARE_NON_COPYABLE(PatternBouncer)
+};
@@ -0,0 +1,108 @@
+#include "PatternCompiler.h"
+
+std::unique_ptr<PatternSchedule> PatternCompiler::compile(const PatternModel& pattern, const TiltMorph& morph)
+{
+    if (!hasCompiled || pattern.getColumnsVersion() != compiledColumnsVersion || morph.getVersion() != compiledMorphVersion)
+        compileColumnPositions(pattern, morph);
+
+    for (auto row{ 0 }; row != pattern.rowsSize(); ++row)
+        if (!hasCompiled || pattern.getRowVersion(row) != compiledRowVersions[row])
+            compileRow(pattern, row);
+
+    hasCompiled = true;
+
+    auto schedule{ std::make_unique<PatternSchedule>() };
+    schedule->columnPositions = columnPositions;
+    schedule->alphaColumnPositions = alphaColumnPositions;
+    schedule->betaMinusAlphaColumnPositions = betaMinusAlphaColumnPositions;
+    mergeRowEvents(schedule->events);
+    schedule->version = ++numberOfCompiles;
+    schedule->rowVersions = compiledRowVersions;
+    schedule->columnsVersion = compiledColumnsVersion;
+
+    return schedule;
+}
+
+void PatternCompiler::compileRow(const PatternModel& pattern, const int& row)
+{
+    auto& events{ rowEvents[row] };
+    events.clear();
+
+    const auto pitch{ static_cast<juce::uint8>(row) };
+    const auto& spans{ pattern.getNoteSpans(row) };
+
+    //a note which wraps around (or ends at) the end of the pattern ends in the next loop, and sounds across the loop point.
+    //a note-on ends the note sounding in its row before it plays (see PatternPlayer::playEvent()), so a note ending where
+    //the row's next note starts, which is itself for a note covering the whole row, has no note-off of its own
+    for (size_t index{ 0 }; index != spans.size(); ++index)
+    {
+        const auto& span{ spans[index] };
+        const auto end{ span.end(pattern.columnsSize()) };
+
+        events.push_back({ span.start, pitch, true });
+
+        if (end != spans[(index + 1) % spans.size()].start)
+            events.push_back({ end, pitch, false });
+    }
+
+    compiledRowVersions[row] = pattern.getRowVersion(row);
+}
+
+void PatternCompiler::compileColumnPositions(const PatternModel& pattern, const TiltMorph& morph)
+{
+    columnPositions.resize(static_cast<size_t>(pattern.columnsSize() + 1));
+
+    for (auto column{ 0 }; column <= pattern.columnsSize(); ++column)
+        columnPositions[column] = pattern.columnStartPosition(column);
+
+    compiledColumnsVersion = pattern.getColumnsVersion();
+    compiledMorphVersion = morph.getVersion();
+
+    alphaColumnPositions.clear();
+    betaMinusAlphaColumnPositions.clear();
+
+    if (!morph.isActive())
+        return;
+
+    std::vector<float> alphaStartPositions, betaMinusAlpha;
+    morph.makeTables(pattern.baseColumnsSize(), alphaStartPositions, betaMinusAlpha);
+
+    //every repeat is morphed the same way, and the end of the pattern doesn't move
+    alphaColumnPositions.resize(columnPositions.size());
+    betaMinusAlphaColumnPositions.resize(columnPositions.size());
+
+    for (auto column{ 0 }; column != pattern.columnsSize(); ++column)
+    {
+        const auto baseColumn{ column % pattern.baseColumnsSize() };
+        alphaColumnPositions[column] = alphaStartPositions[baseColumn] + column / pattern.baseColumnsSize() * CONSTANTS::TICKS_PER_REPEAT;
+        betaMinusAlphaColumnPositions[column] = betaMinusAlpha[baseColumn];
+    }
+
+    alphaColumnPositions.back() = pattern.getLength();
+    betaMinusAlphaColumnPositions.back() = 0.0;
+}
+
+void PatternCompiler::mergeRowEvents(std::vector<PatternSchedule::Event>& events)
+{
+    //a counting sort with two buckets per column, note-offs then note-ons, which rows are added to in ascending order of pitch
+    const auto bucketOf{ [](const PatternSchedule::Event& event) { return event.column * 2 + (event.isNoteOn ? 1 : 0); } };
+
+    bucketStarts.assign(columnPositions.size() * 2, 0);
+    auto numberOfEvents{ 0 };
+
+    for (const auto& row : rowEvents)
+    {
+        for (const auto& event : row)
+            ++bucketStarts[bucketOf(event) + 1];
+
+        numberOfEvents += static_cast<int>(row.size());
+    }
+
+    std::partial_sum(bucketStarts.begin(), bucketStarts.end(), bucketStarts.begin());
+
+    events.resize(static_cast<size_t>(numberOfEvents));
+
+    for (const auto& row : rowEvents)
+        for (const auto& event : row)
+            events[bucketStarts[bucketOf(event)]++] = event;
+}
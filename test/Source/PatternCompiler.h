@@ -0,0 +1,42 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PatternModel.h"
+#include "PatternSchedule.h"
+#include "TiltMorph.h"
+#include "Globals.h"
+
+//compiles PatternModels into PatternSchedules on the message thread. the events of every row are kept between compiles,
+//so only the rows edited since the last compile are compiled again, and only the column positions if the columns or morph changed.
+//this isn't done on a worker thread: what is left of a compile is merging the rows' events into the new schedule, which is
+//O(events + columns) and no more than building an immutable schedule takes anyway, whereas a worker would need the pattern
+//copied for it on the message thread first, at the same cost. edits are published at most once per message loop (see
+//SequencerPanel::handleAsyncUpdate()), so that is all a burst of edits costs
+class PatternCompiler
+{
+public:
+    PatternCompiler() = default;
+
+    //returns a new schedule of pattern, whose column positions are morphed by morph if it is active
+    std::unique_ptr<PatternSchedule> compile(const PatternModel& pattern, const TiltMorph& morph);
+
+private:
+    std::array<std::vector<PatternSchedule::Event>, CONSTANTS::MIDI_PITCHES_SIZE> rowEvents;      //the events of each row, in no particular order
+    std::array<std::uint32_t, CONSTANTS::MIDI_PITCHES_SIZE> compiledRowVersions{};               //the version of each row rowEvents was compiled from
+    std::vector<int> columnPositions;                                                           //see PatternSchedule::columnPositions
+    std::uint32_t compiledColumnsVersion{ 0 };                                                  //the version of the columns columnPositions was compiled from
+    std::vector<double> alphaColumnPositions;                                                   //see PatternSchedule::alphaColumnPositions
+    std::vector<double> betaMinusAlphaColumnPositions;                                          //see PatternSchedule::betaMinusAlphaColumnPositions
+    std::uint32_t compiledMorphVersion{ 0 };                                                    //the version of the morph the tables above were compiled from
+    std::uint32_t numberOfCompiles{ 0 };                                                        //becomes each schedule's version
+    bool hasCompiled{ false };                                                                  //false until the first compile, since every version starts at 0
+    std::vector<int> bucketStarts;                                                              //reused by mergeRowEvents() so it doesn't allocate
+
+    //rebuilds rowEvents[row] from the note spans of row
+    void compileRow(const PatternModel& pattern, const int& row);
+
+    //rebuilds columnPositions from the start positions and repeats of pattern, and the morphed column positions from morph
+    void compileColumnPositions(const PatternModel& pattern, const TiltMorph& morph);
+
+    //merges every row's events into events in the order PatternSchedule::getEvents() promises, in O(events + columns)
+    void mergeRowEvents(std::vector<PatternSchedule::Event>& events);
+};
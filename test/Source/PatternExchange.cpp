@@ -0,0 +1,56 @@
+#include "PatternExchange.h"
+
+PatternExchange::PatternExchange()
+    : currentSchedule(compiler.compile(PatternModel(), TiltMorph()).release())
+{
+}
+
+PatternExchange::~PatternExchange()
+{
+    //the audio thread has stopped by now, so everything can be freed here
+    freeRetiredSchedules();
+    delete pendingSchedule.exchange(nullptr);
+    delete currentSchedule;
+}
+
+void PatternExchange::publish(const PatternModel& pattern, const TiltMorph& morph)
+{
+    freeRetiredSchedules();
+
+    //if the audio thread never picked up the last published schedule it never will, so it is safe to free it
+    delete pendingSchedule.exchange(compiler.compile(pattern, morph).release(), std::memory_order_acq_rel);
+}
+
+const PatternSchedule& PatternExchange::acquire()
+{
+    //the schedule being let go of has to be queued to be freed, so if the queue is full the new schedule waits until the next block
+    if (retiredSchedulesFifo.getFreeSpace() == 0)
+        return *currentSchedule;
+
+    if (auto* newSchedule{ pendingSchedule.exchange(nullptr, std::memory_order_acq_rel) })
+    {
+        int start1, size1, start2, size2;
+        retiredSchedulesFifo.prepareToWrite(1, start1, size1, start2, size2);
+        jassert(size1 == 1);
+        retiredSchedules[static_cast<size_t>(start1)] = currentSchedule;
+        retiredSchedulesFifo.finishedWrite(1);
+
+        currentSchedule = newSchedule;
+    }
+
+    return *currentSchedule;
+}
+
+void PatternExchange::freeRetiredSchedules()
+{
+    int start1, size1, start2, size2;
+    retiredSchedulesFifo.prepareToRead(retiredSchedulesFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (auto index{ start1 }; index != start1 + size1; ++index)
+        delete std::exchange(retiredSchedules[static_cast<size_t>(index)], nullptr);
+
+    for (auto index{ start2 }; index != start2 + size2; ++index)
+        delete std::exchange(retiredSchedules[static_cast<size_t>(index)], nullptr);
+
+    retiredSchedulesFifo.finishedRead(size1 + size2);
+}
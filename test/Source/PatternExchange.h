@@ -0,0 +1,38 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PatternModel.h"
+#include "PatternSchedule.h"
+#include "PatternCompiler.h"
+#include "TiltMorph.h"
+
+//hands the pattern from the message thread to the audio thread without either of them ever waiting for the other.
+//the message thread publishes the pattern compiled into an immutable PatternSchedule, which the audio thread picks up at the
+//start of its next block. the schedule the audio thread lets go of is queued back to the message thread, which frees it, so
+//the audio thread never allocates or frees memory and never takes a lock
+class PatternExchange
+{
+public:
+    PatternExchange();
+
+    ~PatternExchange();
+
+    //message thread only: publishes a schedule of pattern morphed by morph, and frees the schedules the audio thread has finished with
+    void publish(const PatternModel& pattern, const TiltMorph& morph);
+
+    //audio thread only: returns the most recently published schedule, which stays valid until the next call
+    const PatternSchedule& acquire();
+
+    //message thread only: frees the schedules the audio thread has finished with
+    void freeRetiredSchedules();
+
+private:
+    static constexpr int retiredSchedulesCapacity{ 8 };
+
+    PatternCompiler compiler;                                                       //only used by the message thread
+    std::atomic<PatternSchedule*> pendingSchedule{ nullptr };                       //published but not yet picked up by the audio thread
+    PatternSchedule* currentSchedule;                                               //the schedule the audio thread is playing, owned by the audio thread once playing
+    std::array<PatternSchedule*, retiredSchedulesCapacity> retiredSchedules{};      //the schedules the audio thread has let go of, waiting to be freed
+    juce::AbstractFifo retiredSchedulesFifo{ retiredSchedulesCapacity };
+
+    JUCE_DECLARE_NON_COPYABLE(PatternExchange)
+};
@@ -0,0 +1,408 @@
+#include "PatternModel.h"
+
+PatternModel::PatternModel()
+    : cells(static_cast<size_t>(CONSTANTS::MIDI_PITCHES_SIZE), 0)
+{
+    noteSpansAreStale.set();
+}
+
+bool PatternModel::recordNote(const int& row, const int& column, const int& recordedColumnsSize)
+{
+    if (recordedColumnsSize != columnsSize() || row < 0 || row >= rowsSize() || column < 0 || column >= columnsSize() || isOn(row, column))
+        return false;
+
+    //an off cell is never connected, so turning it on makes a note of one column
+    setState(row, column, true);
+
+    return true;
+}
+
+void PatternModel::connectWholeRow(const int& row)
+{
+    const auto rowBegin{ cells.begin() + row * columnsSize() };
+    std::fill(rowBegin, rowBegin + columnsSize(), makeCell(true, true, true));
+    noteSpansAreStale.set(row);
+    ++rowVersions[row];
+    ++version;
+}
+
+void PatternModel::assign(juce::Array<Tick> newStartPositions, const int& newRepeats, std::vector<Cell> newCells)
+{
+    jassert(!newStartPositions.isEmpty() && newStartPositions.getFirst() == 0 && newRepeats >= 1 && newRepeats <= CONSTANTS::MAX_REPEATS);
+    jassert(newCells.size() == static_cast<size_t>(rowsSize() * newStartPositions.size() * newRepeats));
+
+    const auto columnsChanged{ newStartPositions != startPositions || newRepeats != repeats };
+    const auto newColumnsSize{ newStartPositions.size() * newRepeats };
+    auto rowsChanged{ false };
+
+    for (auto row{ 0 }; row != rowsSize(); ++row)
+    {
+        const auto oldRow{ cells.begin() + row * columnsSize() };
+        const auto newRow{ newCells.begin() + row * newColumnsSize };
+
+        if (newColumnsSize == columnsSize() && std::equal(oldRow, oldRow + columnsSize(), newRow))
+            continue;
+
+        noteSpansAreStale.set(row);
+        ++rowVersions[row];
+        rowsChanged = true;
+    }
+
+    startPositions = std::move(newStartPositions);
+    repeats = newRepeats;
+    cells = std::move(newCells);
+
+    if (columnsChanged)
+        ++columnsVersion;
+
+    if (columnsChanged || rowsChanged)
+        ++version;
+}
+
+void PatternModel::setRepeats(const int& newRepeats)
+{
+    //any more couldn't be restored from a saved state (see PatternState::read())
+    const auto clampedRepeats{ juce::jlimit(1, CONSTANTS::MAX_REPEATS, newRepeats) };
+    if (clampedRepeats == repeats)
+        return;
+
+    const auto oldColumnsSize{ columnsSize() };
+
+    //the end of the pattern is moving, so cut notes wrapping around it before it does
+    if (clampedRepeats > repeats)
+        cutNotesWrappingAroundEnd();
+
+    remapColumns(oldColumnsSize, baseColumnsSize() * clampedRepeats, [&oldColumnsSize](const int& column)
+        {
+            return column < oldColumnsSize ? column : -1;
+        });
+
+    repeats = clampedRepeats;
+
+    //notes which were cut by the truncation are left dangling at the new end
+    if (columnsSize() < oldColumnsSize)
+        cutNotesWrappingAroundEnd();
+}
+
+void PatternModel::cutNotesWrappingAroundEnd()
+{
+    for (auto row{ 0 }; row != rowsSize(); ++row)
+    {
+        setIsLeftConnected(row, 0, false);
+        setIsRightConnected(row, columnsSize() - 1, false);
+    }
+}
+
+int PatternModel::insertColumn(Tick startPosition)
+{
+    //since an inserted startPosition will be inserted across all repeats, we use
+    //a start position on the first repeat so the function's logic is uniform
+    startPosition = CUSTOM_FUNCTIONS::positiveMod(startPosition, CONSTANTS::TICKS_PER_REPEAT);
+
+    const auto foundIndex{ findIndex(startPosition) };
+    if (!foundIndex.has_value())
+    {
+        jassertfalse; //a column already starts at startPosition
+        return 0;
+    }
+
+    const auto index{ foundIndex.value() };
+    const auto baseSize{ baseColumnsSize() };
+    const auto newBaseSize{ baseSize + 1 };
+
+    remapColumns(columnsSize(), newBaseSize * repeats, [&](const int& column)
+        {
+            const auto baseColumn{ column % newBaseSize };
+
+            if (baseColumn == index)
+                return -1;
+
+            return (column / newBaseSize) * baseSize + baseColumn - (baseColumn > index);
+        });
+
+    startPositions.insert(index, startPosition);
+
+    for (auto row{ 0 }; row != rowsSize(); ++row)
+        for (auto column{ index }; column < columnsSize(); column += newBaseSize)
+            handleCellConnectionsDuringInsertion(row, column);
+
+    return index;
+}
+
+void PatternModel::handleCellConnectionsDuringInsertion(const int& row, const int& column)
+{
+    const auto leftColumn{ CUSTOM_FUNCTIONS::positiveMod(column - 1, columnsSize()) };
+
+    if (isOn(row, leftColumn))
+    {
+        setCell(row, column, makeCell(true, true, getIsRightConnected(row, leftColumn)));
+        setIsRightConnected(row, leftColumn, true);
+    }
+}
+
+void PatternModel::removeColumn(const int& baseIndex)
+{
+    jassert(baseIndex > 0 && baseIndex < baseColumnsSize());
+
+    const auto baseSize{ baseColumnsSize() };
+    const auto newBaseSize{ baseSize - 1 };
+
+    //connections are handled before removal since they depend on the removed column's neighbours
+    for (auto row{ 0 }; row != rowsSize(); ++row)
+        for (auto column{ baseIndex }; column < columnsSize(); column += baseSize)
+            handleCellConnectionsDuringRemoval(row, column);
+
+    remapColumns(columnsSize(), newBaseSize * repeats, [&](const int& column)
+        {
+            const auto baseColumn{ column % newBaseSize };
+            return (column / newBaseSize) * baseSize + baseColumn + (baseColumn >= baseIndex);
+        });
+
+    startPositions.remove(baseIndex);
+}
+
+void PatternModel::handleCellConnectionsDuringRemoval(const int& row, const int& column)
+{
+    const auto leftColumn{ CUSTOM_FUNCTIONS::positiveMod(column - 1, columnsSize()) };
+    const auto rightColumn{ CUSTOM_FUNCTIONS::positiveMod(column + 1, columnsSize()) };
+
+    const auto leftIsConnected{ getIsRightConnected(row, leftColumn) };
+    const auto rightIsConnected{ getIsLeftConnected(row, rightColumn) };
+
+    if (leftIsConnected && !rightIsConnected)
+        setIsRightConnected(row, leftColumn, false);
+    else if (!leftIsConnected && rightIsConnected)
+        setIsLeftConnected(row, rightColumn, false);
+}
+
+bool PatternModel::startPositionsIsValid(const juce::Array<Tick>& posiblyInvalidStartPositions) const
+{
+    if (posiblyInvalidStartPositions.isEmpty())
+        return true;
+
+    return std::find_if(posiblyInvalidStartPositions.begin(), posiblyInvalidStartPositions.end(),
+            [](const Tick& position)
+            {
+                return position <= 0 || position >= CONSTANTS::TICKS_PER_REPEAT; //ensure positions are in range (0, TICKS_PER_REPEAT)
+            })
+            == posiblyInvalidStartPositions.end() &&
+        std::adjacent_find(posiblyInvalidStartPositions.begin(), posiblyInvalidStartPositions.end(),
+            [](const Tick& positionA, const Tick& positionB)
+            {
+                return positionA >= positionB; //ensure positions are in ascending order
+            })
+            == posiblyInvalidStartPositions.end();
+}
+
+void PatternModel::shiftStartPositions(juce::Array<Tick> newStartPositions)
+{
+    jassert(newStartPositions.size() == baseColumnsSize() - 1);
+
+    jassert(startPositionsIsValid(newStartPositions));
+
+    newStartPositions.insert(0, 0);
+    startPositions = newStartPositions;
+    ++columnsVersion;
+    ++version;
+}
+
+std::optional<int> PatternModel::findIndex(Tick startPosition) const
+{
+    startPosition = CUSTOM_FUNCTIONS::positiveMod(startPosition, CONSTANTS::TICKS_PER_REPEAT);
+
+    //the index is after the last column starting at or before startPosition, which is never before column 0 since it starts at 0
+    const auto index{ static_cast<int>(std::upper_bound(startPositions.begin(), startPositions.end(), startPosition) - startPositions.begin()) };
+
+    if (startPositions.getUnchecked(index - 1) == startPosition)
+        return std::nullopt;
+
+    return index;
+}
+
+PatternModel::Tick PatternModel::columnStartPosition(const int& column) const
+{
+    const auto cashedBaseColumnsSize{ baseColumnsSize() };
+    jassert(column >= 0 && column <= cashedBaseColumnsSize * repeats);
+
+    return startPositions.getUnchecked(column % cashedBaseColumnsSize) + column / cashedBaseColumnsSize * CONSTANTS::TICKS_PER_REPEAT;
+}
+
+PatternModel::Tick PatternModel::columnWidth(const int& column) const
+{
+    return columnStartPosition(column + 1) - columnStartPosition(column);
+}
+
+void PatternModel::shuffleRow(const int& row, const int& offset)
+{
+    if (row < 0 || row >= rowsSize() || offset == 0 || row + offset < 0 || row + offset >= rowsSize())
+    {
+        jassertfalse;
+        return;
+    }
+
+    const auto newRow{ row + offset };
+    const auto rowBegin{ [this](const int& rowIndex) { return cells.begin() + rowIndex * columnsSize(); } };
+
+    if (newRow > row) // Shift left
+        std::rotate(rowBegin(row), rowBegin(row + 1), rowBegin(newRow + 1));
+    else // Shift right
+        std::rotate(rowBegin(newRow), rowBegin(row), rowBegin(row + 1));
+
+    for (auto shuffledRow{ std::min(row, newRow) }; shuffledRow <= std::max(row, newRow); ++shuffledRow)
+    {
+        noteSpansAreStale.set(shuffledRow);
+        ++rowVersions[shuffledRow];
+    }
+
+    ++version;
+}
+
+bool PatternModel::rowIsInValidState(const int& row) const
+{
+    const auto cellName{ [&row](const int& column)
+        {
+            return "cell (" + juce::String(row) + ", " + juce::String(column) + ")";
+        } };
+    juce::ignoreUnused(cellName);
+
+    for (auto column{ 0 }; column != columnsSize(); ++column)
+        if (isOn(row, column))
+        {
+            if (getIsLeftConnected(row, column) &&
+                !getIsRightConnected(row, CUSTOM_FUNCTIONS::positiveMod(column - 1, columnsSize())))
+            {
+                DBG(cellName(column) + " is left-connected but shouldn't be.");
+                return false;
+            }
+            if (getIsRightConnected(row, column) &&
+                !getIsLeftConnected(row, CUSTOM_FUNCTIONS::positiveMod(column + 1, columnsSize())))
+            {
+                DBG(cellName(column) + " is right-connected but shouldn't be.");
+                return false;
+            }
+        }
+        else
+        {
+            if (getIsLeftConnected(row, column))
+            {
+                DBG(cellName(column) + " is off but left-connected.");
+                return false;
+            }
+            if (getIsRightConnected(row, column))
+            {
+                DBG(cellName(column) + " is off but right-connected.");
+                return false;
+            }
+        }
+
+    return true;
+}
+
+const PatternModel::NoteSpans& PatternModel::getNoteSpans(const int& row) const
+{
+    if (noteSpansAreStale[row])
+        rebuildNoteSpans(row);
+
+    return noteSpans[row];
+}
+
+void PatternModel::rebuildNoteSpans(const int& row) const
+{
+    auto& rowSpans{ noteSpans[row] };
+    rowSpans.clear();
+
+    for (auto column{ 0 }; column != columnsSize(); ++column)
+        if (const auto span{ findNoteStartingAt(row, column) })
+            rowSpans.push_back(span.value());
+
+    noteSpansAreStale.reset(row);
+}
+
+void PatternModel::updateNoteSpansAround(const int& row, const int& column) const
+{
+    const auto size{ columnsSize() };
+
+    //column's neighbours are each other, or column itself
+    if (size < 3)
+    {
+        noteSpansAreStale.set(row);
+        return;
+    }
+
+    auto& rowSpans{ noteSpans[row] };
+    const auto leftColumn{ CUSTOM_FUNCTIONS::positiveMod(column - 1, size) };
+    const auto rightColumn{ (column + 1) % size };
+    const auto startIsBefore{ [](const NoteSpan& span, const int& start) { return span.start < start; } };
+
+    //writing column can only change whether notes start at column and rightColumn, and the length of notes crossing either
+    //edge of column, which covered leftColumn, column or rightColumn before. so every note the write can have split,
+    //merged, shortened or lengthened is found again from one of these starts, and the rest are left as they are
+    std::array<int, 5> starts{ column, rightColumn };
+    auto startsSize{ 2 };
+
+    for (const auto& coveredColumn : { leftColumn, column, rightColumn })
+    {
+        const auto span{ findNoteSpan(rowSpans, coveredColumn, size) };
+        if (!span.has_value())
+            continue;
+
+        rowSpans.erase(std::lower_bound(rowSpans.begin(), rowSpans.end(), span->start, startIsBefore));
+
+        if (std::find(starts.begin(), starts.begin() + startsSize, span->start) == starts.begin() + startsSize)
+            starts[static_cast<size_t>(startsSize++)] = span->start;
+    }
+
+    for (auto index{ 0 }; index != startsSize; ++index)
+        if (const auto span{ findNoteStartingAt(row, starts[static_cast<size_t>(index)]) })
+            rowSpans.insert(std::lower_bound(rowSpans.begin(), rowSpans.end(), span->start, startIsBefore), span.value());
+}
+
+bool PatternModel::isConnectedToRightColumn(const int& row, const int& column) const
+{
+    const auto rightColumn{ (column + 1) % columnsSize() };
+    return getIsRightConnected(row, column) && isOn(row, rightColumn) && getIsLeftConnected(row, rightColumn);
+}
+
+std::optional<PatternModel::NoteSpan> PatternModel::findNoteStartingAt(const int& row, const int& column) const
+{
+    const auto size{ columnsSize() };
+
+    //a note starts on any on cell which isn't connected to the cell to its left
+    if (!isOn(row, column) || isConnectedToRightColumn(row, CUSTOM_FUNCTIONS::positiveMod(column - 1, size)))
+        return std::nullopt;
+
+    auto length{ 1 };
+    while (length < size && isConnectedToRightColumn(row, (column + length - 1) % size))
+        ++length;
+
+    return NoteSpan{ column, length };
+}
+
+std::optional<PatternModel::NoteSpan> PatternModel::findNoteSpan(const NoteSpans& spans, const int& column, const int& columnsSize)
+{
+    if (spans.empty())
+        return std::nullopt;
+
+    //the only note which can cover column is the last one starting at or before it...
+    auto iterator{ std::upper_bound(spans.begin(), spans.end(), column,
+        [](const int& value, const NoteSpan& span) { return value < span.start; }) };
+
+    //...or, if none start before it, the last note of the row wrapping around the end of the pattern
+    const auto& candidate{ iterator != spans.begin() ? *std::prev(iterator) : spans.back() };
+    const auto distanceFromStart{ CUSTOM_FUNCTIONS::positiveMod(column - candidate.start, columnsSize) };
+
+    if (distanceFromStart < candidate.length)
+        return candidate;
+
+    return std::nullopt;
+}
+
+std::pair<PatternModel::NoteSpans::const_iterator, PatternModel::NoteSpans::const_iterator>
+    PatternModel::getNoteSpansStartingIn(const int& row, const int& fromColumn, const int& toColumn) const
+{
+    const auto& rowSpans{ getNoteSpans(row) };
+    const auto startIsBefore{ [](const NoteSpan& span, const int& value) { return span.start < value; } };
+
+    return { std::lower_bound(rowSpans.begin(), rowSpans.end(), fromColumn, startIsBefore),
+             std::lower_bound(rowSpans.begin(), rowSpans.end(), toColumn, startIsBefore) };
+}
@@ -0,0 +1,253 @@
+#pragma once
+#include <JuceHeader.h>
+#include <bitset>
+#include "Globals.h"
+
+//the headless model of a drum pattern: the state and connections of every cell, and the column
+//layout (start positions and repeats) they sit on. SequencerPanel only views and edits this.
+//cells are packed flags in one contiguous row-major buffer, so a row scan reads columnsSize()
+//consecutive bytes rather than chasing a juce::Component per cell
+class PatternModel
+{
+public:
+    //a cell is a byte of packed CellFlags
+    using Cell = std::uint8_t;
+
+    enum CellFlags : Cell
+    {
+        onFlag = 1 << 0,
+        leftConnectedFlag = 1 << 1,
+        rightConnectedFlag = 1 << 2
+    };
+
+    //a note in a row (a "greater cell"), i.e. a run of connected on cells which may wrap around the end of the pattern
+    struct NoteSpan
+    {
+        int start;      //the column the note starts on
+        int length;     //the number of columns the note covers
+
+        //returns the column after the last column of the note, wrapping around columnsSize (exclusive like all right bounds)
+        int end(const int& columnsSize) const { return (start + length) % columnsSize; };
+
+        bool operator==(const NoteSpan& other) const { return start == other.start && length == other.length; };
+    };
+
+    //the note spans of a row, in ascending order of start
+    using NoteSpans = std::vector<NoteSpan>;
+
+    //start positions are whole numbers of ticks, CONSTANTS::TICKS_PER_REPEAT to a repeat, so they are exact at any number of repeats
+    using Tick = int;
+
+    //converts a position in repeats to the nearest tick
+    static Tick toTicks(const double& positionInRepeats) { return juce::roundToInt(positionInRepeats * CONSTANTS::TICKS_PER_REPEAT); };
+
+    PatternModel();
+
+    static constexpr Cell makeCell(const bool& isOn, const bool& isLeftConnected, const bool& isRightConnected)
+    {
+        return static_cast<Cell>((isOn ? onFlag : 0) | (isLeftConnected ? leftConnectedFlag : 0) | (isRightConnected ? rightConnectedFlag : 0));
+    };
+
+    //returns the number of rows in the pattern
+    int rowsSize() const { return CONSTANTS::MIDI_PITCHES_SIZE; };
+
+    //returns the total number of columns in the pattern
+    int columnsSize() const { return startPositions.size() * repeats; };
+
+    //returns the number of base columns (i.e. not counting repeats)
+    int baseColumnsSize() const { return startPositions.size(); };
+
+    //returns the number of times the base columns layout is repeated
+    int getRepeats() const { return repeats; };
+
+    //returns a number which changes every time the pattern is edited, so a copy can tell if it is out of date
+    std::uint32_t getVersion() const { return version; };
+
+    //as above but only changes when a cell in row is edited, or when the columns are inserted, removed or repeated
+    std::uint32_t getRowVersion(const int& row) const { return rowVersions[row]; };
+
+    //as above but only changes when the columns or their start positions change
+    std::uint32_t getColumnsVersion() const { return columnsVersion; };
+
+    //returns the length of the whole pattern in ticks
+    Tick getLength() const { return repeats * CONSTANTS::TICKS_PER_REPEAT; };
+
+    //returns the start positions of the base columns in ticks
+    const juce::Array<Tick>& getStartPositions() const { return startPositions; };
+
+    //does no bounds checking ;D
+    Cell getCell(const int& row, const int& column) const { return cells[row * columnsSize() + column]; };
+
+    //copies the cells of row into destination, which keeps its storage between calls
+    void copyRow(const int& row, std::vector<Cell>& destination) const
+    {
+        const auto rowBegin{ cells.begin() + row * columnsSize() };
+        destination.assign(rowBegin, rowBegin + columnsSize());
+    };
+
+    //does no bounds checking ;D
+    void setCell(const int& row, const int& column, const Cell& cell) { writeCell(row, column, cell); };
+
+    bool isOn(const int& row, const int& column) const { return getCell(row, column) & onFlag; };
+
+    bool getIsLeftConnected(const int& row, const int& column) const { return getCell(row, column) & leftConnectedFlag; };
+
+    bool getIsRightConnected(const int& row, const int& column) const { return getCell(row, column) & rightConnectedFlag; };
+
+    void setState(const int& row, const int& column, const bool& shouldBeOn) { setFlag(row, column, onFlag, shouldBeOn); };
+
+    void setIsLeftConnected(const int& row, const int& column, const bool& shouldBeConnected) { setFlag(row, column, leftConnectedFlag, shouldBeConnected); };
+
+    void setIsRightConnected(const int& row, const int& column, const bool& shouldBeConnected) { setFlag(row, column, rightConnectedFlag, shouldBeConnected); };
+
+    //turns the cell off and disconnects it
+    void turnOff(const int& row, const int& column) { writeCell(row, column, 0); };
+
+    //turns the cell at (row, column) on as a note of its own, unless it is already on, e.g. for a recorded note-on.
+    //recordedColumnsSize is the number of columns column was counted in, if that isn't columnsSize() the note is dropped.
+    //returns true if the cell was turned on
+    bool recordNote(const int& row, const int& column, const int& recordedColumnsSize);
+
+    //connects the whole row, this actually puts the row in an invalid state since there is no note beginning
+    void connectWholeRow(const int& row);
+
+    //sets the number of times the base columns layout is repeated, clamped to [1, CONSTANTS::MAX_REPEATS], added columns are off
+    void setRepeats(const int& newRepeats);
+
+    //inserts a column at startPosition and all its repeats, returns the base index it was inserted at
+    //a column must not already start at startPosition (see findIndex())
+    int insertColumn(Tick startPosition);
+
+    //removes the base column at baseIndex and all its repeats
+    void removeColumn(const int& baseIndex);
+
+    //it is the responsiblity of the caller to ensure these are valid and in ascending order
+    void shiftStartPositions(juce::Array<Tick> newStartPositions);
+
+    bool startPositionsIsValid(const juce::Array<Tick>& posiblyInvalidStartPositions) const;
+
+    //finds the base index startPosition would be inserted at in startPositions in O(log n), or nullopt if a column
+    //already starts there, startPosition is wrapped into the first repeat
+    std::optional<int> findIndex(Tick startPosition) const;
+
+    //returns the start position of column in ticks, counting from the start of the first repeat
+    //helpfully, this function returns getLength() if column is equal to columnsSize()
+    Tick columnStartPosition(const int& column) const;
+
+    //returns the width of a column in ticks
+    Tick columnWidth(const int& column) const;
+
+    //replaces the whole pattern in one pass, newCells being rowsSize() * newStartPositions.size() * newRepeats cells row by
+    //row. newStartPositions must start at 0 and otherwise be valid (see startPositionsIsValid()), and newRepeats in [1, MAX_REPEATS].
+    //versions move on as after any other edit, rather than being copied from wherever the pattern came from, but only those
+    //of what actually changed: a row's only if its cells differ, so anything cached by row version stays valid for the rest
+    void assign(juce::Array<Tick> newStartPositions, const int& newRepeats, std::vector<Cell> newCells);
+
+    //as above but copies the start positions, repeats and cells of other
+    void assign(const PatternModel& other) { assign(other.startPositions, other.repeats, other.cells); };
+
+    //moves a row by offset, shifting the rows in between towards where it was
+    void shuffleRow(const int& row, const int& offset);
+
+    //returns true only if the row is valid
+    bool rowIsInValidState(const int& row) const;
+
+    //returns the note spans of row, rebuilding them first if the row has been edited since they were last asked for
+    const NoteSpans& getNoteSpans(const int& row) const;
+
+    //returns the span of the note covering column in row in O(log n), or nullopt if there is no such note
+    //(the cell is off, or the row is connected all the way around so no note starts anywhere)
+    std::optional<NoteSpan> findNoteSpan(const int& row, const int& column) const { return findNoteSpan(getNoteSpans(row), column, columnsSize()); };
+
+    //as above but searches any spans, e.g. ones copied before an edit, whose row has columnsSize columns
+    static std::optional<NoteSpan> findNoteSpan(const NoteSpans& spans, const int& column, const int& columnsSize);
+
+    //returns the range of note spans in row which start in [fromColumn, toColumn), found in O(log n)
+    std::pair<NoteSpans::const_iterator, NoteSpans::const_iterator> getNoteSpansStartingIn(const int& row, const int& fromColumn, const int& toColumn) const;
+
+private:
+    juce::Array<Tick> startPositions{ 0 };      //the start positions of the base columns in ticks, in ascending order and in the range [0, TICKS_PER_REPEAT)
+    int repeats{ 1 };                           //the number of times the base columns layout is repeated
+    std::vector<Cell> cells;                    //rowsSize() * columnsSize() cells, row by row
+    std::uint32_t version{ 0 };                 //incremented by every edit (see getVersion())
+    std::array<std::uint32_t, CONSTANTS::MIDI_PITCHES_SIZE> rowVersions{};      //incremented by every edit to a row (see getRowVersion())
+    std::uint32_t columnsVersion{ 0 };          //incremented by every edit to the columns (see getColumnsVersion())
+
+    mutable std::array<NoteSpans, CONSTANTS::MIDI_PITCHES_SIZE> noteSpans;          //the notes of each row, derived from cells
+    mutable std::bitset<CONSTANTS::MIDI_PITCHES_SIZE> noteSpansAreStale;            //set for a row when it is edited in bulk (e.g. by remapColumns())
+
+    //every write to a single cell goes through here. the note spans of its row are updated around the cell rather than
+    //rebuilt, so e.g. every step of a drag doesn't cost a scan of the whole row
+    void writeCell(const int& row, const int& column, const Cell& newCell)
+    {
+        auto& cell{ cells[row * columnsSize() + column] };
+        if (cell == newCell)
+            return;
+
+        cell = newCell;
+        ++rowVersions[row];
+        ++version;
+
+        if (!noteSpansAreStale[row])
+            updateNoteSpansAround(row, column);
+    };
+
+    //rebuilds the note spans of row from its cells in a single pass
+    void rebuildNoteSpans(const int& row) const;
+
+    //brings the note spans of row up to date after only the cell at column was written, by finding again just the notes
+    //which covered it or its neighbours, in O(log n) plus the length of those notes
+    void updateNoteSpansAround(const int& row, const int& column) const;
+
+    //returns true if the cell at column in row and the cell to its right are connected to each other, i.e. are in the same note
+    bool isConnectedToRightColumn(const int& row, const int& column) const;
+
+    //returns the note starting at column in row, or nullopt if no note starts there
+    std::optional<NoteSpan> findNoteStartingAt(const int& row, const int& column) const;
+
+    void setFlag(const int& row, const int& column, const CellFlags& flag, const bool& shouldBeSet)
+    {
+        const auto cell{ getCell(row, column) };
+        writeCell(row, column, static_cast<Cell>(shouldBeSet ? (cell | flag) : (cell & ~flag)));
+    };
+
+    //rebuilds cells with newColumnsSize columns in a single pass, oldColumnOf maps a new column to
+    //the old column it is copied from, or to -1 if the new column should be off
+    template <typename ColumnMapping>
+    void remapColumns(const int& oldColumnsSize, const int& newColumnsSize, ColumnMapping&& oldColumnOf)
+    {
+        std::vector<int> oldColumns(static_cast<size_t>(newColumnsSize));
+        for (auto column{ 0 }; column != newColumnsSize; ++column)
+            oldColumns[column] = oldColumnOf(column);
+
+        std::vector<Cell> newCells(static_cast<size_t>(rowsSize() * newColumnsSize), 0);
+
+        for (auto row{ 0 }; row != rowsSize(); ++row)
+        {
+            const auto oldRow{ cells.data() + row * oldColumnsSize };
+            auto newRow{ newCells.data() + row * newColumnsSize };
+
+            for (auto column{ 0 }; column != newColumnsSize; ++column)
+                if (oldColumns[column] >= 0)
+                    newRow[column] = oldRow[oldColumns[column]];
+        }
+
+        cells.swap(newCells);
+        noteSpansAreStale.set();
+
+        for (auto& rowVersion : rowVersions)
+            ++rowVersion;
+
+        ++columnsVersion;
+        ++version;
+    };
+
+    //disconnects notes which wrap around the end of the pattern, called when the end moves
+    void cutNotesWrappingAroundEnd();
+
+    //a note which was playing over an inserted column is extended to cover it
+    void handleCellConnectionsDuringInsertion(const int& row, const int& column);
+
+    //a note which started or ended on a removed column now starts or ends on its neighbour
+    void handleCellConnectionsDuringRemoval(const int& row, const int& column);
+};
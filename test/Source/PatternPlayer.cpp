@@ -0,0 +1,245 @@
+#include "PatternPlayer.h"
+
+void PatternPlayer::prepare(const double& newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+
+    sampleRate = newSampleRate;
+    position = 0.0;
+    nextEvent = 0;
+    isPlaying = false;
+    expectedPpqPosition = 0.0;
+    soundingNotes.reset();
+    lastBlockSegmentsSize = 0;
+}
+
+std::optional<PatternPlayer::Transport> PatternPlayer::getHostTransport(juce::AudioPlayHead* playHead)
+{
+    if (playHead == nullptr)
+        return std::nullopt;
+
+    const auto positionInfo{ playHead->getPosition() };
+    if (!positionInfo.hasValue())
+        return std::nullopt;
+
+    const auto ppqPosition{ positionInfo->getPpqPosition() };
+    const auto beatsPerMinute{ positionInfo->getBpm() };
+    if (!ppqPosition.hasValue() || !beatsPerMinute.hasValue())
+        return std::nullopt;
+
+    Transport transport;
+    transport.isPlaying = positionInfo->getIsPlaying();
+    transport.ppqPosition = *ppqPosition;
+    transport.beatsPerMinute = *beatsPerMinute;
+
+    //a repeat lasts a bar, so its length in quarter notes follows the time signature
+    if (const auto timeSignature{ positionInfo->getTimeSignature() })
+        if (timeSignature->numerator > 0 && timeSignature->denominator > 0)
+            transport.quarterNotesPerRepeat = 4.0 * timeSignature->numerator / timeSignature->denominator;
+
+    if (const auto loopPoints{ positionInfo->getLoopPoints() })
+    {
+        transport.isLooping = positionInfo->getIsLooping();
+        transport.loopStart = loopPoints->ppqStart;
+        transport.loopEnd = loopPoints->ppqEnd;
+    }
+
+    return transport;
+}
+
+void PatternPlayer::renderNextBlock(const PatternSchedule& schedule, juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples)
+{
+    Transport transport;
+    transport.ppqPosition = expectedPpqPosition;
+    transport.beatsPerMinute = beatsPerMinute;
+
+    renderNextBlock(schedule, transport, midiMessages, startSample, numSamples);
+}
+
+void PatternPlayer::renderNextBlock(const PatternSchedule& schedule, const Transport& transport, juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples)
+{
+    lastBlockSegmentsSize = 0;
+
+    if (numSamples <= 0)
+        return;
+
+    if (!transport.isPlaying || transport.beatsPerMinute <= 0.0 || transport.quarterNotesPerRepeat <= 0.0)
+    {
+        if (isPlaying)
+            endSoundingNotes(midiMessages, startSample);
+
+        isPlaying = false;
+        return;
+    }
+
+    const auto quarterNotesPerSample{ transport.beatsPerMinute / 60.0 / sampleRate };
+    const auto hasLoop{ transport.isLooping && transport.loopEnd > transport.loopStart };
+
+    auto ppqPosition{ transport.ppqPosition };
+    auto sample{ 0 };
+
+    //the block is split where the transport loops, the second segment then starts with a jump back to loopStart
+    while (sample != numSamples)
+    {
+        auto segmentLength{ numSamples - sample };
+        auto loops{ false };
+
+        if (hasLoop && ppqPosition < transport.loopEnd)
+        {
+            const auto samplesUntilLoopEnd{ juce::jmax(1, samplesUntil(transport.loopEnd - ppqPosition, quarterNotesPerSample)) };
+
+            loops = samplesUntilLoopEnd <= segmentLength;
+            segmentLength = juce::jmin(segmentLength, samplesUntilLoopEnd);
+        }
+
+        renderSegment(schedule, transport, ppqPosition, midiMessages, startSample + sample, segmentLength);
+
+        sample += segmentLength;
+
+        //the transport loops at the first sample at or after loopEnd, which is taken to be loopStart exactly, since adding
+        //up the samples can land a rounding error either side of loopEnd and so short of it, or past the events at loopStart
+        ppqPosition = loops ? transport.loopStart : ppqPosition + segmentLength * quarterNotesPerSample;
+    }
+}
+
+void PatternPlayer::renderSegment(const PatternSchedule& schedule, const Transport& transport, const double& ppqPosition,
+                                  juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples)
+{
+    followHost(schedule, ppqPosition, transport.quarterNotesPerRepeat, midiMessages, startSample);
+
+    if (schedule.getVersion() != playedVersion)
+        handleScheduleChange(schedule, midiMessages, startSample);
+
+    const auto& events{ schedule.getEvents() };
+    const auto sampleLength{ transport.beatsPerMinute / 60.0 / sampleRate / transport.quarterNotesPerRepeat * CONSTANTS::TICKS_PER_REPEAT };
+
+    lastBlockSegments[static_cast<size_t>(juce::jmin(lastBlockSegmentsSize, maxSegmentsPerBlock - 1))] = { startSample, position, sampleLength };
+    lastBlockSegmentsSize = juce::jmin(lastBlockSegmentsSize + 1, maxSegmentsPerBlock);
+    playedLength = schedule.getLength();
+
+    while (true)
+    {
+        if (nextEvent == static_cast<int>(events.size()))
+        {
+            if (samplesUntil(schedule.getLength() - position, sampleLength) >= numSamples)
+                break;
+
+            //the pattern loops in this block, so carry on from the start of the next loop
+            nextEvent = 0;
+            position -= schedule.getLength();
+            continue;
+        }
+
+        const auto sampleOffset{ samplesUntil(schedule.getEventPosition(nextEvent, tilt) - position, sampleLength) };
+        if (sampleOffset >= numSamples)
+            break;
+
+        playEvent(events[static_cast<size_t>(nextEvent++)], midiMessages, startSample + std::max(0, sampleOffset));
+    }
+
+    position += numSamples * sampleLength;
+    expectedPpqPosition = ppqPosition + numSamples * transport.beatsPerMinute / 60.0 / sampleRate;
+}
+
+void PatternPlayer::followHost(const PatternSchedule& schedule, const double& ppqPosition, const double& quarterNotesPerRepeat,
+                               juce::MidiBuffer& midiMessages, const int& sampleOffset)
+{
+    const auto length{ static_cast<double>(schedule.getLength()) };
+    const auto hostTicks{ ppqPosition / quarterNotesPerRepeat * CONSTANTS::TICKS_PER_REPEAT };
+    const auto hostPosition{ hostTicks - length * std::floor(hostTicks / length) };
+
+    const auto isContinuation{ isPlaying && quarterNotesPerRepeat == playedQuarterNotesPerRepeat
+                               && std::abs(ppqPosition - expectedPpqPosition) <= relocationThreshold };
+
+    isPlaying = true;
+    playedQuarterNotesPerRepeat = quarterNotesPerRepeat;
+
+    if (isContinuation)
+    {
+        //the cursor is kept, and the host's position is taken from the loop of the pattern nearest to ours, so events
+        //the host skipped over are played at the start of the block and events it went back over aren't played again
+        position = hostPosition + length * std::round((position - hostPosition) / length);
+        return;
+    }
+
+    endSoundingNotes(midiMessages, sampleOffset);
+    position = hostPosition;
+    seek(schedule);
+}
+
+std::optional<double> PatternPlayer::getPositionInLastBlock(const int& sampleOffset) const
+{
+    if (lastBlockSegmentsSize == 0)
+        return std::nullopt;
+
+    //the last segment starting at or before sampleOffset
+    auto segmentIndex{ lastBlockSegmentsSize - 1 };
+    while (segmentIndex > 0 && lastBlockSegments[static_cast<size_t>(segmentIndex)].startSample > sampleOffset)
+        --segmentIndex;
+
+    const auto& segment{ lastBlockSegments[static_cast<size_t>(segmentIndex)] };
+    const auto segmentPosition{ segment.position + (sampleOffset - segment.startSample) * segment.sampleLength };
+
+    return segmentPosition - playedLength * std::floor(segmentPosition / playedLength);
+}
+
+void PatternPlayer::stop(juce::MidiBuffer& midiMessages, const int& sampleOffset)
+{
+    endSoundingNotes(midiMessages, sampleOffset);
+    position = 0.0;
+    nextEvent = 0;
+    isPlaying = false;
+    expectedPpqPosition = 0.0;
+    lastBlockSegmentsSize = 0;
+}
+
+void PatternPlayer::endSoundingNotes(juce::MidiBuffer& midiMessages, const int& sampleOffset)
+{
+    for (auto row{ 0 }; row != CONSTANTS::MIDI_PITCHES_SIZE; ++row)
+        if (soundingNotes[row])
+            midiMessages.addEvent(juce::MidiMessage::noteOff(midiChannel, row), sampleOffset);
+
+    soundingNotes.reset();
+}
+
+void PatternPlayer::seek(const PatternSchedule& schedule)
+{
+    position -= schedule.getLength() * std::floor(position / schedule.getLength());
+    nextEvent = schedule.findFirstEventFrom(position, tilt);
+}
+
+void PatternPlayer::handleScheduleChange(const PatternSchedule& schedule, juce::MidiBuffer& midiMessages, const int& sampleOffset)
+{
+    //only the start positions of the columns changing leaves every note-off on the column it was, so only the rows whose
+    //cells changed (which includes every row when columns are inserted or removed) have their notes ended
+    for (auto row{ 0 }; row != CONSTANTS::MIDI_PITCHES_SIZE; ++row)
+    {
+        if (soundingNotes[row] && schedule.getRowVersion(row) != playedRowVersions[row])
+        {
+            midiMessages.addEvent(juce::MidiMessage::noteOff(midiChannel, row), sampleOffset);
+            soundingNotes.reset(row);
+        }
+
+        playedRowVersions[row] = schedule.getRowVersion(row);
+    }
+
+    playedVersion = schedule.getVersion();
+
+    seek(schedule);
+}
+
+void PatternPlayer::playEvent(const PatternSchedule::Event& event, juce::MidiBuffer& midiMessages, const int& sampleOffset)
+{
+    //a note-off whose note-on was never played (e.g. one wrapping around the end of the pattern on the first loop) is skipped
+    if (soundingNotes[event.pitch])
+    {
+        midiMessages.addEvent(juce::MidiMessage::noteOff(midiChannel, event.pitch), sampleOffset);
+        soundingNotes.reset(event.pitch);
+    }
+
+    if (event.isNoteOn)
+    {
+        midiMessages.addEvent(juce::MidiMessage::noteOn(midiChannel, event.pitch, noteVelocity), sampleOffset);
+        soundingNotes.set(event.pitch);
+    }
+}
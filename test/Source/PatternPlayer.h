@@ -0,0 +1,120 @@
+#pragma once
+#include <JuceHeader.h>
+#include <bitset>
+#include "PatternSchedule.h"
+#include "Globals.h"
+
+//plays a PatternSchedule in real time, writing each of its events into a juce::MidiBuffer at the exact sample it falls on.
+//playback only advances a cursor through the schedule's events, so a block costs O(events in the block) however wide the
+//pattern is. nothing here allocates or locks, so renderNextBlock() is safe to call from processBlock() at any buffer size
+class PatternPlayer
+{
+public:
+    //the host's transport at the start of a block (see juce::AudioPlayHead::PositionInfo), positions are in quarter notes
+    struct Transport
+    {
+        bool isPlaying{ true };
+        double ppqPosition{ 0.0 };
+        double beatsPerMinute{ CONSTANTS::DEFAULT_BEATS_PER_MINUTE };
+        double quarterNotesPerRepeat{ CONSTANTS::BEATS_PER_REPEAT };       //a repeat lasts a bar, so this follows the time signature
+        bool isLooping{ false };
+        double loopStart{ 0.0 };
+        double loopEnd{ 0.0 };
+    };
+
+    PatternPlayer() = default;
+
+    //returns the transport playHead reports at the start of the current block, or nullopt if there is no playHead or it
+    //doesn't provide a position and tempo
+    static std::optional<Transport> getHostTransport(juce::AudioPlayHead* playHead);
+
+    //must be called before playback with the sample rate it will run at, returns to the start of the pattern
+    void prepare(const double& newSampleRate);
+
+    //sets the tempo used when there is no host transport to follow
+    void setBeatsPerMinute(const double& newBeatsPerMinute) { beatsPerMinute = newBeatsPerMinute; };
+
+    double getBeatsPerMinute() const { return beatsPerMinute; };
+
+    //sets the tilt the columns of a morphed schedule are played at (see PatternSchedule::isMorphed()), from the next block on.
+    //events the change moves behind the playback position are played at the start of the block, so none are missed
+    void setTilt(const float& newTilt) { tilt = newTilt; };
+
+    float getTilt() const { return tilt; };
+
+    //returns the playback position in ticks, in the range [0, schedule.getLength())
+    double getPosition() const { return position; };
+
+    //returns the position in ticks, in the range [0, schedule.getLength()), at sampleOffset (counted like the MidiBuffer's
+    //sample positions) in the last block rendered, or nullopt if the pattern wasn't playing then
+    std::optional<double> getPositionInLastBlock(const int& sampleOffset) const;
+
+    //writes the events of schedule which fall in the next numSamples samples into midiMessages, offset by startSample,
+    //running freely from the end of the last block at getBeatsPerMinute()
+    void renderNextBlock(const PatternSchedule& schedule, juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples);
+
+    //as above but locked to transport: the position is taken from the host every block, so it never drifts, and jumps
+    //(relocation, or the transport looping inside or between blocks) end every sounding note and play on from the new position
+    void renderNextBlock(const PatternSchedule& schedule, const Transport& transport, juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples);
+
+    //ends every sounding note at sampleOffset in midiMessages and returns to the start of the pattern
+    void stop(juce::MidiBuffer& midiMessages, const int& sampleOffset);
+
+    static constexpr int midiChannel{ 1 };
+    static constexpr juce::uint8 noteVelocity{ 100 };
+
+    //the host's position can differ from where the last block ended by this much (in quarter notes) without being a jump,
+    //e.g. when the tempo changed during the last block
+    static constexpr double relocationThreshold{ 1.0 / 64.0 };
+
+    //the most segments (see renderSegment()) of a block getPositionInLastBlock() can tell apart, later ones share the last
+    static constexpr int maxSegmentsPerBlock{ 8 };
+
+private:
+    //where a segment of the last block started playing from
+    struct Segment
+    {
+        int startSample;
+        double position;
+        double sampleLength;
+    };
+
+    double sampleRate{ 44100.0 };
+    double beatsPerMinute{ CONSTANTS::DEFAULT_BEATS_PER_MINUTE };
+    double position{ 0.0 };                                                     //the position at the start of the next block, in ticks
+    float tilt{ 0.f };                                                          //see setTilt()
+    int nextEvent{ 0 };                                                         //the index of the next event to be played
+    bool isPlaying{ false };                                                    //false until the first block, and while the host is stopped
+    double expectedPpqPosition{ 0.0 };                                          //where the host should be at the start of the next block if it didn't jump
+    double playedQuarterNotesPerRepeat{ CONSTANTS::BEATS_PER_REPEAT };          //the length of a repeat the last block was played with
+    std::bitset<CONSTANTS::MIDI_PITCHES_SIZE> soundingNotes;                    //set for a row while its note-on has been sent but its note-off hasn't
+    std::uint32_t playedVersion{ 0 };                                           //the version of the schedule last played
+    std::array<std::uint32_t, CONSTANTS::MIDI_PITCHES_SIZE> playedRowVersions{};
+    std::array<Segment, maxSegmentsPerBlock> lastBlockSegments{};
+    int lastBlockSegmentsSize{ 0 };
+    double playedLength{ CONSTANTS::TICKS_PER_REPEAT };                         //the length of the schedule the last block was played from
+
+    //returns the number of whole samples before something distance away, where a sample is sampleLength long. positions
+    //taken from the host carry rounding error, so a distance within a millionth of a sample of a whole sample counts as one
+    static int samplesUntil(const double& distance, const double& sampleLength) { return static_cast<int>(std::ceil(distance / sampleLength - 1.0e-6)); };
+
+    //plays numSamples samples from ppqPosition, which the transport doesn't loop or jump within
+    void renderSegment(const PatternSchedule& schedule, const Transport& transport, const double& ppqPosition,
+                       juce::MidiBuffer& midiMessages, const int& startSample, const int& numSamples);
+
+    //moves position to ppqPosition, the nearest way round the loop of the pattern if this is a continuation of the last block
+    void followHost(const PatternSchedule& schedule, const double& ppqPosition, const double& quarterNotesPerRepeat,
+                    juce::MidiBuffer& midiMessages, const int& sampleOffset);
+
+    //a new schedule may have moved or removed the note-offs of sounding notes, so the sounding notes of rows which were edited
+    //are ended at sampleOffset, then nextEvent is found again from position
+    void handleScheduleChange(const PatternSchedule& schedule, juce::MidiBuffer& midiMessages, const int& sampleOffset);
+
+    //ends every sounding note at sampleOffset
+    void endSoundingNotes(juce::MidiBuffer& midiMessages, const int& sampleOffset);
+
+    //wraps position into the pattern and finds nextEvent from it
+    void seek(const PatternSchedule& schedule);
+
+    void playEvent(const PatternSchedule::Event& event, juce::MidiBuffer& midiMessages, const int& sampleOffset);
+};
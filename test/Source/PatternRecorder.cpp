@@ -0,0 +1,35 @@
+#include "PatternRecorder.h"
+
+void PatternRecorder::collectNoteOns(const juce::MidiBuffer& midiMessages)
+{
+    noteOnsSize = 0;
+
+    for (const auto metadata : midiMessages)
+    {
+        if (noteOnsSize == maxNoteOnsPerBlock)
+            break;
+
+        const auto message{ metadata.getMessage() };
+        if (message.isNoteOn())
+            noteOns[static_cast<size_t>(noteOnsSize++)] = { metadata.samplePosition, message.getNoteNumber() };
+    }
+}
+
+void PatternRecorder::quantizeNoteOns(const PatternPlayer& player, const PatternSchedule& schedule)
+{
+    for (auto index{ 0 }; index != noteOnsSize; ++index)
+    {
+        const auto& noteOn{ noteOns[static_cast<size_t>(index)] };
+
+        const auto position{ player.getPositionInLastBlock(noteOn.sampleOffset) };
+        if (!position.has_value() || hitsFifo.getFreeSpace() == 0)
+            continue;
+
+        int start1, size1, start2, size2;
+        hitsFifo.prepareToWrite(1, start1, size1, start2, size2);
+        hits[static_cast<size_t>(start1)] = { noteOn.row, schedule.findNearestColumn(position.value(), player.getTilt()), schedule.columnsSize() };
+        hitsFifo.finishedWrite(1);
+    }
+
+    noteOnsSize = 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PatternPlayer.h"
+#include "PatternSchedule.h"
+#include "Globals.h"
+
+//records the note-ons coming into processBlock() into the pattern. each note-on is quantized on the audio thread to the
+//column whose start is nearest to where the pattern was playing when it arrived (a binary search over the schedule's
+//column positions, so it stays cheap however many columns there are), then queued to the message thread as a hit, where
+//the cell is turned on. nothing here allocates or locks, and hits which don't fit in the queue are dropped
+class PatternRecorder
+{
+public:
+    //a note-on quantized to a cell
+    struct Hit
+    {
+        int row;
+        int column;
+        int columnsSize;    //the number of columns of the schedule column was quantized in, if that has changed so may column's meaning
+    };
+
+    PatternRecorder() = default;
+
+    //audio thread only: remembers the note-ons in midiMessages, which must be called before the pattern's own are added to it
+    void collectNoteOns(const juce::MidiBuffer& midiMessages);
+
+    //audio thread only: quantizes the collected note-ons to the columns of schedule at the positions player played them at,
+    //once player has rendered the block, and queues them to the message thread
+    void quantizeNoteOns(const PatternPlayer& player, const PatternSchedule& schedule);
+
+    //message thread only: calls handleHit with every queued hit, oldest first
+    template <typename HitHandler>
+    void takeHits(HitHandler&& handleHit)
+    {
+        int start1, size1, start2, size2;
+        hitsFifo.prepareToRead(hitsFifo.getNumReady(), start1, size1, start2, size2);
+
+        for (auto index{ start1 }; index != start1 + size1; ++index)
+            handleHit(hits[static_cast<size_t>(index)]);
+
+        for (auto index{ start2 }; index != start2 + size2; ++index)
+            handleHit(hits[static_cast<size_t>(index)]);
+
+        hitsFifo.finishedRead(size1 + size2);
+    };
+
+    static constexpr int maxNoteOnsPerBlock{ 128 };    //note-ons past this in a block aren't recorded
+    static constexpr int hitsCapacity{ 512 };           //how many hits can wait for the message thread
+
+private:
+    //a note-on waiting to be quantized
+    struct NoteOn
+    {
+        int sampleOffset;
+        int row;
+    };
+
+    std::array<NoteOn, maxNoteOnsPerBlock> noteOns{};      //audio thread only
+    int noteOnsSize{ 0 };
+    std::array<Hit, hitsCapacity> hits{};
+    juce::AbstractFifo hitsFifo{ hitsCapacity };
+
+    JUCE_DECLARE_NON_COPYABLE(PatternRecorder)
+};
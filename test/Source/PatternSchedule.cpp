@@ -0,0 +1,49 @@
+#include "PatternSchedule.h"
+
+int PatternSchedule::findFirstColumnFrom(const double& position, const float& tilt) const
+{
+    auto column{ 0 };
+    for (auto count{ columnsSize() }; count > 0;)
+    {
+        const auto half{ count / 2 };
+
+        if (getColumnPosition(column + half, tilt) < position)
+        {
+            column += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+
+    return column;
+}
+
+int PatternSchedule::findNearestColumn(const double& position, const float& tilt) const
+{
+    //position lies between the start of the column before this one and the start of this one (or the end of the pattern)
+    const auto column{ findFirstColumnFrom(position, tilt) };
+
+    if (column == 0)
+        return 0;
+
+    const auto nextStart{ getColumnPosition(column, tilt) };
+    const auto previousStart{ getColumnPosition(column - 1, tilt) };
+
+    if (position - previousStart < nextStart - position)
+        return column - 1;
+
+    return column == columnsSize() ? 0 : column;
+}
+
+int PatternSchedule::findFirstEventFrom(const double& position, const float& tilt) const
+{
+    //the first column starting at or after position, then the first event on or after that column
+    const auto column{ findFirstColumnFrom(position, tilt) };
+    const auto iterator{ std::lower_bound(events.begin(), events.end(), column,
+        [](const Event& event, const int& value) { return event.column < value; }) };
+
+    return static_cast<int>(iterator - events.begin());
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Globals.h"
+
+//a PatternModel compiled into the note-ons and note-offs it plays, in the order they are played, so playback only has to advance
+//a cursor through events rather than look at any cells. schedules are built by PatternCompiler and never change afterwards.
+//if the schedule was compiled with a TiltMorph, the start positions of the columns depend on the tilt they are played at
+class PatternSchedule
+{
+public:
+    struct Event
+    {
+        int column;             //the column at whose start the event happens
+        juce::uint8 pitch;      //the row of the note, which is also its MIDI note number
+        bool isNoteOn;          //true for a note-on, false for a note-off
+    };
+
+    PatternSchedule() = default;
+
+    //returns the events of one loop of the pattern, ordered by column, then note-offs before note-ons, then pitch
+    const std::vector<Event>& getEvents() const { return events; };
+
+    //returns the number of columns in the pattern
+    int columnsSize() const { return static_cast<int>(columnPositions.size()) - 1; };
+
+    //returns true if the start positions of the columns depend on tilt
+    bool isMorphed() const { return !alphaColumnPositions.empty(); };
+
+    //returns the position of the start of column in ticks at tilt, columnsSize() gives the end of the pattern
+    double getColumnPosition(const int& column, const float& tilt) const
+    {
+        return isMorphed() ? alphaColumnPositions[column] + tilt * betaMinusAlphaColumnPositions[column] : columnPositions[column];
+    };
+
+    //returns the position of the event at index in ticks at tilt
+    double getEventPosition(const int& index, const float& tilt) const { return getColumnPosition(events[index].column, tilt); };
+
+    //returns the length of the pattern in ticks, which doesn't depend on tilt
+    int getLength() const { return columnPositions.back(); };
+
+    //returns the first column starting at or after position (in ticks) at tilt, or columnsSize() if there is none, in O(log n)
+    int findFirstColumnFrom(const double& position, const float& tilt) const;
+
+    //returns the column whose start is nearest to position (in ticks, in the range [0, getLength())) at tilt in O(log n),
+    //a position nearer the end of the pattern than the start of the last column quantizes to column 0 of the next loop
+    int findNearestColumn(const double& position, const float& tilt) const;
+
+    //returns the index of the first event at or after position (in ticks) at tilt, or events.size() if there is none, in O(log n)
+    int findFirstEventFrom(const double& position, const float& tilt) const;
+
+    //returns a number which changes every time a schedule is compiled
+    std::uint32_t getVersion() const { return version; };
+
+    //these are the versions of the PatternModel the schedule was compiled from (see PatternModel::getRowVersion())
+    std::uint32_t getRowVersion(const int& row) const { return rowVersions[row]; };
+
+    std::uint32_t getColumnsVersion() const { return columnsVersion; };
+
+private:
+    friend class PatternCompiler;
+
+    std::vector<Event> events;                                                      //every event in one loop of the pattern, in the order they are played
+    std::vector<int> columnPositions{ 0, CONSTANTS::TICKS_PER_REPEAT };             //the start position of every column in ticks followed by the end of the pattern
+    std::vector<double> alphaColumnPositions;                                       //as above at a tilt of 0, empty unless the schedule is morphed
+    std::vector<double> betaMinusAlphaColumnPositions;                              //how far each column moves from a tilt of 0 to a tilt of 1
+    std::uint32_t version{ 0 };
+    std::array<std::uint32_t, CONSTANTS::MIDI_PITCHES_SIZE> rowVersions{};
+    std::uint32_t columnsVersion{ 0 };
+};
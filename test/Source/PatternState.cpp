@@ -0,0 +1,278 @@
+#include "PatternState.h"
+
+void PatternState::write(const PatternModel& pattern, const Session& session, Cache& cache, juce::MemoryBlock& destination)
+{
+    //nothing has been edited since the last state was written, e.g. when a host polls the state of every instance
+    if (isUpToDate(pattern, session, cache))
+    {
+        destination = cache.state;
+        return;
+    }
+
+    //read() rejects any more, so a state with more couldn't be restored
+    jassert(pattern.getRepeats() >= 1 && pattern.getRepeats() <= CONSTANTS::MAX_REPEATS);
+
+    encodeRows(pattern, cache);
+
+    const auto& startPositions{ pattern.getStartPositions() };
+    const auto rowPlanesSize{ 3 * planeSize(cache.columnsSize) };
+
+    //the most the state can take, the block is shrunk to what it did take at the end
+    const auto maxSize{ sizeof(magic) + 1 + static_cast<size_t>(maxVarintSize * (startPositions.size() + 4)) + 4 + 1
+                        + rowMaskSize + static_cast<size_t>(pattern.rowsSize()) * rowPlanesSize };
+    cache.state.setSize(maxSize, false);
+
+    const auto begin{ static_cast<std::uint8_t*>(cache.state.getData()) };
+    Writer writer{ begin };
+
+    for (const auto& byte : magic)
+        writer.writeByte(byte);
+
+    writer.writeByte(formatVersion);
+
+    //the gaps between start positions are small, so they take fewer bytes than the positions would
+    writer.writeVarint(static_cast<std::uint32_t>(startPositions.size()));
+    for (auto index{ 1 }; index < startPositions.size(); ++index)
+        writer.writeVarint(static_cast<std::uint32_t>(startPositions.getUnchecked(index) - startPositions.getUnchecked(index - 1)));
+
+    writer.writeVarint(static_cast<std::uint32_t>(pattern.getRepeats()));
+    writer.writeVarint(static_cast<std::uint32_t>(session.referenceRow));
+    writer.writeVarint(static_cast<std::uint32_t>(session.visibleRows));
+    writer.writeFloat(session.tilt);
+    writer.writeByte(static_cast<std::uint8_t>((session.useDrumSampler ? useDrumSamplerFlag : 0) | (session.morphColumns ? morphColumnsFlag : 0)));
+
+    writer.data = std::copy(cache.rowMask.begin(), cache.rowMask.end(), writer.data);
+
+    //the rows are copied as they were encoded, rows of cells which are all just off aren't written at all
+    for (auto row{ 0 }; row != pattern.rowsSize(); ++row)
+        if (cache.rowMask[row / 8] & (1 << (row % 8)))
+        {
+            const auto planes{ cache.rowPlanes.data() + row * rowPlanesSize };
+            writer.data = std::copy(planes, planes + rowPlanesSize, writer.data);
+        }
+
+    cache.state.setSize(static_cast<size_t>(writer.data - begin), false);
+    cache.patternVersion = pattern.getVersion();
+    cache.session = session;
+
+    destination = cache.state;
+}
+
+void PatternState::encodeRows(const PatternModel& pattern, Cache& cache)
+{
+    const auto columnsSize{ pattern.columnsSize() };
+    const auto rowPlanesSize{ 3 * planeSize(columnsSize) };
+
+    //every row's planes change size, so every row is encoded again
+    const auto columnsSizeChanged{ columnsSize != cache.columnsSize };
+    if (columnsSizeChanged)
+    {
+        cache.columnsSize = columnsSize;
+        cache.rowPlanes.resize(static_cast<size_t>(pattern.rowsSize()) * rowPlanesSize);
+    }
+
+    for (auto row{ 0 }; row != pattern.rowsSize(); ++row)
+    {
+        if (!columnsSizeChanged && cache.rowVersions[row] == pattern.getRowVersion(row))
+            continue;
+
+        const auto planes{ cache.rowPlanes.data() + row * rowPlanesSize };
+        std::fill(planes, planes + rowPlanesSize, std::uint8_t{ 0 });
+
+        const auto bit{ static_cast<std::uint8_t>(1 << (row % 8)) };
+        if (encodeRow(pattern, row, planes))
+            cache.rowMask[row / 8] |= bit;
+        else
+            cache.rowMask[row / 8] &= static_cast<std::uint8_t>(~bit);
+
+        cache.rowVersions[row] = pattern.getRowVersion(row);
+    }
+}
+
+bool PatternState::encodeRow(const PatternModel& pattern, const int& row, std::uint8_t* planes)
+{
+    const auto columnsSize{ pattern.columnsSize() };
+    const auto onPlane{ planes };
+    const auto leftConnectedPlane{ onPlane + planeSize(columnsSize) };
+    const auto rightConnectedPlane{ leftConnectedPlane + planeSize(columnsSize) };
+
+    PatternModel::Cell rowFlags{ 0 };
+
+    for (auto column{ 0 }; column != columnsSize; ++column)
+    {
+        const auto cell{ pattern.getCell(row, column) };
+        const auto byte{ column / 8 };
+        const auto bit{ static_cast<std::uint8_t>(1 << (column % 8)) };
+
+        if (cell & PatternModel::onFlag)
+            onPlane[byte] |= bit;
+
+        if (cell & PatternModel::leftConnectedFlag)
+            leftConnectedPlane[byte] |= bit;
+
+        if (cell & PatternModel::rightConnectedFlag)
+            rightConnectedPlane[byte] |= bit;
+
+        rowFlags |= cell;
+    }
+
+    return rowFlags != 0;
+}
+
+bool PatternState::read(const void* data, const int& sizeInBytes, PatternModel& pattern, Session& session)
+{
+    if (data == nullptr || sizeInBytes <= 0)
+        return false;
+
+    const auto begin{ static_cast<const std::uint8_t*>(data) };
+    Reader reader{ begin, begin + sizeInBytes };
+
+    const auto header{ reader.readBytes(sizeof(magic) + 1) };
+    if (header == nullptr || header[0] != magic[0] || header[1] != magic[1] || header[2] == 0 || header[2] > formatVersion)
+        return false;
+
+    const auto baseColumnsSize{ reader.readVarint() };
+    if (!baseColumnsSize.has_value() || baseColumnsSize.value() < 1 || baseColumnsSize.value() > static_cast<std::uint32_t>(CONSTANTS::TICKS_PER_REPEAT))
+        return false;
+
+    juce::Array<PatternModel::Tick> startPositions;
+    startPositions.ensureStorageAllocated(static_cast<int>(baseColumnsSize.value()));
+    startPositions.add(0);
+
+    for (auto index{ 1u }; index != baseColumnsSize.value(); ++index)
+    {
+        //start positions are in ascending order and within the first repeat
+        const auto gap{ reader.readVarint() };
+        if (!gap.has_value() || gap.value() == 0 || gap.value() >= static_cast<std::uint32_t>(CONSTANTS::TICKS_PER_REPEAT - startPositions.getLast()))
+            return false;
+
+        startPositions.add(startPositions.getLast() + static_cast<PatternModel::Tick>(gap.value()));
+    }
+
+    const auto repeats{ reader.readVarint() };
+    const auto referenceRow{ reader.readVarint() };
+    const auto visibleRows{ reader.readVarint() };
+    const auto tilt{ reader.readFloat() };
+    const auto flags{ reader.readByte() };
+    const auto rowMask{ reader.readBytes(rowMaskSize) };
+
+    if (!repeats.has_value() || repeats.value() < 1 || repeats.value() > static_cast<std::uint32_t>(CONSTANTS::MAX_REPEATS)
+        || !referenceRow.has_value() || !visibleRows.has_value() || visibleRows.value() < 1
+        || visibleRows.value() > static_cast<std::uint32_t>(CONSTANTS::MIDI_PITCHES_SIZE)
+        || referenceRow.value() > static_cast<std::uint32_t>(CONSTANTS::MIDI_PITCHES_SIZE) - visibleRows.value()
+        || !tilt.has_value() || !std::isfinite(tilt.value()) || !flags.has_value() || rowMask == nullptr)
+        return false;
+
+    const auto columnsSize{ static_cast<int>(baseColumnsSize.value() * repeats.value()) };
+    const auto rowPlaneSize{ planeSize(columnsSize) };
+    std::vector<PatternModel::Cell> cells(static_cast<size_t>(CONSTANTS::MIDI_PITCHES_SIZE * columnsSize), 0);
+
+    for (auto row{ 0 }; row != CONSTANTS::MIDI_PITCHES_SIZE; ++row)
+    {
+        if ((rowMask[row / 8] & (1 << (row % 8))) == 0)
+            continue;
+
+        const auto onPlane{ reader.readBytes(3 * rowPlaneSize) };
+        if (onPlane == nullptr)
+            return false;
+
+        const auto leftConnectedPlane{ onPlane + rowPlaneSize };
+        const auto rightConnectedPlane{ leftConnectedPlane + rowPlaneSize };
+        auto cell{ cells.data() + row * columnsSize };
+
+        for (auto column{ 0 }; column != columnsSize; ++column, ++cell)
+        {
+            const auto byte{ column / 8 };
+            const auto shift{ column % 8 };
+
+            *cell = PatternModel::makeCell((onPlane[byte] >> shift) & 1,
+                                           (leftConnectedPlane[byte] >> shift) & 1,
+                                           (rightConnectedPlane[byte] >> shift) & 1);
+        }
+    }
+
+    pattern.assign(std::move(startPositions), static_cast<int>(repeats.value()), std::move(cells));
+
+    session.referenceRow = static_cast<int>(referenceRow.value());
+    session.visibleRows = static_cast<int>(visibleRows.value());
+    session.tilt = juce::jlimit(0.f, 1.f, tilt.value());
+    session.useDrumSampler = (flags.value() & useDrumSamplerFlag) != 0;
+    session.morphColumns = header[2] < 2 || (flags.value() & morphColumnsFlag) != 0;
+
+    return true;
+}
+
+void PatternState::Writer::writeVarint(std::uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        writeByte(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    writeByte(static_cast<std::uint8_t>(value));
+}
+
+void PatternState::Writer::writeFloat(const float& value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    for (auto byte{ 0 }; byte != 4; ++byte)
+        writeByte(static_cast<std::uint8_t>(bits >> (8 * byte)));
+}
+
+std::optional<std::uint8_t> PatternState::Reader::readByte()
+{
+    if (data == end)
+        return std::nullopt;
+
+    return *data++;
+}
+
+std::optional<std::uint32_t> PatternState::Reader::readVarint()
+{
+    std::uint32_t value{ 0 };
+
+    for (auto byte{ 0 }; byte != maxVarintSize; ++byte)
+    {
+        if (data == end)
+            return std::nullopt;
+
+        const auto next{ *data++ };
+        value |= static_cast<std::uint32_t>(next & 0x7f) << (7 * byte);
+
+        if ((next & 0x80) == 0)
+            return value;
+    }
+
+    //too long to be a 32 bit varint
+    return std::nullopt;
+}
+
+std::optional<float> PatternState::Reader::readFloat()
+{
+    const auto bytes{ readBytes(4) };
+    if (bytes == nullptr)
+        return std::nullopt;
+
+    std::uint32_t bits{ 0 };
+    for (auto byte{ 0 }; byte != 4; ++byte)
+        bits |= static_cast<std::uint32_t>(bytes[byte]) << (8 * byte);
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+const std::uint8_t* PatternState::Reader::readBytes(const size_t& size)
+{
+    if (static_cast<size_t>(end - data) < size)
+        return nullptr;
+
+    const auto bytes{ data };
+    data += size;
+
+    return bytes;
+}
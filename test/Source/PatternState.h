@@ -0,0 +1,112 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PatternModel.h"
+#include "Globals.h"
+
+//the compact binary format the processor's state is saved in, so hosts saving or loading an instance (e.g. autosaving
+//every instance in a project) spend microseconds on it rather than a round trip through XML. in order, a state is:
+//  magic and format version    3 bytes, 'T' 'S' and formatVersion
+//  base columns size           varint, followed by the gap in ticks from each base start position to the next
+//  repeats                     varint
+//  reference row               varint
+//  visible rows                varint
+//  tilt                        4 bytes, a little endian float
+//  flags                       1 byte, bit 0 is useDrumSampler and bit 1 morphColumns (from version 2, before which
+//                              the columns were always morphed)
+//  row mask                    16 bytes, bit n (of byte n / 8) is set if row n has a cell which isn't just off
+//  rows                        for each row in the mask, 3 bit planes of columnsSize() bits (on, left connected,
+//                              right connected), each padded to a whole byte
+//varints are unsigned LEB128, 7 bits to a byte and the high bit set on every byte but the last
+class PatternState
+{
+public:
+    //everything besides the pattern which is saved with it
+    struct Session
+    {
+        int referenceRow{ 60 };         //the lowest row visible on the tilt panel
+        int visibleRows{ 8 };           //the number of rows visible on the tilt panel
+        float tilt{ 0.f };
+        bool useDrumSampler{ true };
+        bool morphColumns{ true };
+
+        bool operator==(const Session& other) const
+        {
+            return referenceRow == other.referenceRow && visibleRows == other.visibleRows && tilt == other.tilt && useDrumSampler == other.useDrumSampler
+                && morphColumns == other.morphColumns;
+        };
+    };
+
+    //what the states written with it were made of, so writing the next one only encodes the rows edited since (found by
+    //their row versions), and writing one when nothing has been edited at all is a copy. since it goes by the versions of
+    //the pattern, a cache must only ever be used with the one pattern
+    struct Cache
+    {
+        int columnsSize{ -1 };                                                      //the number of columns the rows were encoded with, -1 before any were
+        std::array<std::uint32_t, CONSTANTS::MIDI_PITCHES_SIZE> rowVersions{};      //the version of each row when it was encoded
+        std::array<std::uint8_t, CONSTANTS::MIDI_PITCHES_SIZE / 8> rowMask{};       //the row mask of the encoded rows
+        std::vector<std::uint8_t> rowPlanes;                                        //the bit planes of every row, row by row, empty rows included
+        std::uint32_t patternVersion{ 0 };                                          //the version of the pattern state was written from
+        Session session;                                                            //the session state was written from
+        juce::MemoryBlock state;                                                    //the last state written, empty before the first
+    };
+
+    //returns true if the last state written with cache was of pattern and session as they are now
+    static bool isUpToDate(const PatternModel& pattern, const Session& session, const Cache& cache)
+    {
+        return cache.state.getSize() > 0 && cache.patternVersion == pattern.getVersion() && cache.session == session;
+    };
+
+    //replaces the contents of destination with pattern and session, only encoding the rows of pattern edited since the
+    //last state written with cache
+    static void write(const PatternModel& pattern, const Session& session, Cache& cache, juce::MemoryBlock& destination);
+
+    //decodes data into pattern and session in a single pass, returns false (leaving both as they were) if data isn't a
+    //whole state in this or an earlier version of the format
+    static bool read(const void* data, const int& sizeInBytes, PatternModel& pattern, Session& session);
+
+    static constexpr std::uint8_t formatVersion{ 2 };
+
+private:
+    static constexpr std::uint8_t magic[]{ 'T', 'S' };
+    static constexpr int rowMaskSize{ CONSTANTS::MIDI_PITCHES_SIZE / 8 };
+    static constexpr int maxVarintSize{ 5 };        //the most bytes a 32 bit varint takes
+    static constexpr std::uint8_t useDrumSamplerFlag{ 1 << 0 };
+    static constexpr std::uint8_t morphColumnsFlag{ 1 << 1 };
+
+    //writes to a buffer known to be big enough for everything written to it
+    struct Writer
+    {
+        std::uint8_t* data;
+
+        void writeByte(const std::uint8_t& byte) { *data++ = byte; };
+
+        void writeVarint(std::uint32_t value);
+
+        void writeFloat(const float& value);
+    };
+
+    //reads from a buffer, returning nullopt or nullptr rather than reading past its end
+    struct Reader
+    {
+        const std::uint8_t* data;
+        const std::uint8_t* end;
+
+        std::optional<std::uint8_t> readByte();
+
+        std::optional<std::uint32_t> readVarint();
+
+        std::optional<float> readFloat();
+
+        //returns a pointer to the next size bytes and skips them, or nullptr if there aren't that many left
+        const std::uint8_t* readBytes(const size_t& size);
+    };
+
+    //brings the encoded rows of cache up to date with pattern, encoding only the rows edited since it last was
+    static void encodeRows(const PatternModel& pattern, Cache& cache);
+
+    //writes the 3 bit planes of row to planes, which must be zeroed, returns false if every cell of the row is just off
+    static bool encodeRow(const PatternModel& pattern, const int& row, std::uint8_t* planes);
+
+    //returns the number of bytes a bit plane of a row of columnsSize cells takes
+    static size_t planeSize(const int& columnsSize) { return static_cast<size_t>((columnsSize + 7) / 8); };
+};
@@ -3,10 +3,23 @@
 
 TestAudioProcessorEditor::TestAudioProcessorEditor(TestAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p)
+    , sequencerPanel(p.getPattern(), 1, SequencerPanel::virtualisedRendering)
 {
     //setWantsKeyboardFocus(true);
     //addKeyListener(this);
 
+    //the pattern lives in the processor, so opening the editor copies nothing and a reopened editor carries on from it.
+    //the panel starts with one visible row so any saved window fits when it is moved there
+    sequencerPanel.setVisibleWindow(audioProcessor.getReferenceRow(), audioProcessor.getVisibleRows());
+    displayedRestoredStatesCount = audioProcessor.getRestoredStatesCount();
+    sequencerPanel.onPatternChanged = [this](const PatternModel&) { audioProcessor.publishPattern(); };
+    audioProcessor.onNoteRecorded = [this](const int& row, const int& column) { sequencerPanel.showRecordedNote(row, column); };
+    audioProcessor.canRecordIntoRow = [this](const int& row) { return !sequencerPanel.isDraggingRow(row); };
+
+    //the strips start out with the processor's own grids, so this only publishes if they have been changed
+    audioProcessor.setTiltGrids(alphaSequencerStrip.getStartPositions(), betaSequencerStrip.getStartPositions());
+    sequencerPanel.showMorph(&audioProcessor.getTiltMorph(), audioProcessor.getTilt());
+
     addAndMakeVisible(sequencerPanel);
     addAndMakeVisible(alphaSequencerStrip);
     addAndMakeVisible(betaSequencerStrip);
@@ -17,18 +30,33 @@ TestAudioProcessorEditor::TestAudioProcessorEditor(TestAudioProcessor& p)
     prepare(insertColumn);
     prepare(removeColumn);
     prepare(setColumns);
+    prepare(bounce);
+    prepare(morphColumns);
+    morphColumns.setToggleState(audioProcessor.getMorphColumns(), juce::dontSendNotification);
+    setColumns.setEnabled(!audioProcessor.getTiltMorph().isActive());
 
     setSize(CONSTANTS::WINDOW_WIDTH, CONSTANTS::WINDOW_HEIGHT);
+
+    startTimerHz(30);
 }
 
 TestAudioProcessorEditor::~TestAudioProcessorEditor()
 {
+    stopTimer();
+    audioProcessor.onNoteRecorded = nullptr;
+    audioProcessor.canRecordIntoRow = nullptr;
+
+    //edits the panel hasn't reported yet would otherwise not be played until the editor is next opened
+    audioProcessor.publishPattern();
+
     addVisibleRow.removeListener(this);
     removeVisibleRow.removeListener(this);
     setRepeats.removeListener(this);
     insertColumn.removeListener(this);
     removeColumn.removeListener(this);
     setColumns.removeListener(this);
+    bounce.removeListener(this);
+    morphColumns.removeListener(this);
 }
 
 //==============================================================================
@@ -45,6 +73,8 @@ void TestAudioProcessorEditor::resized()
     insertColumn.setBounds(200, 10, 100, 20);
     removeColumn.setBounds(200, 40, 100, 20);
     setColumns.setBounds(300, 40, 100, 20);
+    bounce.setBounds(300, 10, 100, 20);
+    morphColumns.setBounds(400, 10, 100, 20);
 
     const auto& localBounds{ getLocalBounds() };
     const auto& localHeight{ localBounds.getHeight() };
@@ -84,7 +114,7 @@ void TestAudioProcessorEditor::buttonClicked(juce::Button* button)
     if (button == &insertColumn)
     {
         //const auto startPosition{  };
-        sequencerPanel.insertColumn(((1 + juce::Random::getSystemRandom().nextFloat()) / 3) * sequencerPanel.getRepeats());
+        sequencerPanel.insertColumn(PatternModel::toTicks(((1 + juce::Random::getSystemRandom().nextFloat()) / 3) * sequencerPanel.getRepeats()));
     }
     if (button == &removeColumn)
     {
@@ -97,14 +127,68 @@ void TestAudioProcessorEditor::buttonClicked(juce::Button* button)
     }
     if (button == &setColumns)
     {
-        juce::Array<float> newStartPositions;
+        juce::Array<PatternModel::Tick> newStartPositions;
         newStartPositions.ensureStorageAllocated(sequencerPanel.baseColumnsSize() - 1);
         for (auto i{ 0 }; i != sequencerPanel.baseColumnsSize() - 1; ++i)
-            newStartPositions.add(((1 + juce::Random::getSystemRandom().nextFloat()) / 3));
+            newStartPositions.add(PatternModel::toTicks((1 + juce::Random::getSystemRandom().nextFloat()) / 3));
 
         std::sort(newStartPositions.begin(), newStartPositions.end());
         sequencerPanel.shiftStartPositions(newStartPositions);
     }
+    if (button == &morphColumns)
+    {
+        //with the morph off the columns are where the pattern puts them, so setColumns can move them again
+        audioProcessor.setMorphColumns(!audioProcessor.getMorphColumns());
+        morphColumns.setToggleState(audioProcessor.getMorphColumns(), juce::dontSendNotification);
+        sequencerPanel.showMorph(&audioProcessor.getTiltMorph(), audioProcessor.getTilt());
+        setColumns.setEnabled(!audioProcessor.getTiltMorph().isActive());
+    }
+    if (button == &bounce)
+    {
+        //one pass of the pattern, next to each other in the user's documents
+        const auto midiFile{ juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getNonexistentChildFile("pattern", ".mid") };
+        audioProcessor.bouncePattern(sequencerPanel.getRepeats(), midiFile, midiFile.withFileExtension(".wav"));
+    }
+}
+
+bool TestAudioProcessorEditor::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    return files.size() == 1;
+}
+
+void TestAudioProcessorEditor::filesDropped(const juce::StringArray& files, int x, int y)
+{
+    const auto location{ sequencerPanel.getLocalPoint(this, juce::Point<int>(x, y)) };
+    if (!sequencerPanel.getLocalBounds().contains(location))
+        return;
+
+    //a file which can't be read is ignored, leaving the row's sample as it was
+    if (const auto row{ sequencerPanel.getRowAtY(location.getY()) })
+        audioProcessor.loadDrumSample(row.value(), juce::File(files[0]));
+}
+
+void TestAudioProcessorEditor::timerCallback()
+{
+    if (audioProcessor.getRestoredStatesCount() != displayedRestoredStatesCount)
+        showRestoredState();
+
+    audioProcessor.setVisibleWindow(sequencerPanel.getReferenceRow(), sequencerPanel.getVisibleRows());
+
+    //only where the columns are drawn follows tilt, the pattern keeps its own start positions and isn't published again
+    sequencerPanel.showMorph(&audioProcessor.getTiltMorph(), audioProcessor.getTilt());
+
+    //the panel ignores start positions while it shows the morph, so there is nothing for setColumns to set until the
+    //morph is turned off, which the host may do too
+    setColumns.setEnabled(!audioProcessor.getTiltMorph().isActive());
+    morphColumns.setToggleState(audioProcessor.getMorphColumns(), juce::dontSendNotification);
+}
+
+void TestAudioProcessorEditor::showRestoredState()
+{
+    displayedRestoredStatesCount = audioProcessor.getRestoredStatesCount();
+
+    sequencerPanel.syncWithPattern();
+    sequencerPanel.setVisibleWindow(audioProcessor.getReferenceRow(), audioProcessor.getVisibleRows());
 }
 
 void TestAudioProcessorEditor::prepare(juce::Button& button)
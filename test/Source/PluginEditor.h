@@ -7,6 +7,8 @@
 
 class TestAudioProcessorEditor  : public juce::AudioProcessorEditor
                                 , private juce::Button::Listener
+                                , private juce::Timer
+                                , public juce::FileDragAndDropTarget
                                 //, private juce::KeyListener
 {
 public:
@@ -18,11 +20,21 @@ public:
 
     void buttonClicked(juce::Button* button) override;
 
+    //audio files dropped on a row of the tilt panel are loaded into the drum sampler for that row
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
+    //shows a state the processor has restored, and draws the tilt panel's columns where the processor's tilt plays them
+    //(playback doesn't wait for this)
+    void timerCallback() override;
+
 private:
     TestAudioProcessor& audioProcessor;
-    SequencerPanel sequencerPanel{ 8 };
-    SequencerStrip alphaSequencerStrip{ 3 },
-                   betaSequencerStrip{ 4 };
+    SequencerPanel sequencerPanel;                  //views the processor's pattern, painting only the visible cells
+    SequencerStrip alphaSequencerStrip{ CONSTANTS::ALPHA_GRID_COLUMNS },
+                   betaSequencerStrip{ CONSTANTS::BETA_GRID_COLUMNS };
+    int displayedRestoredStatesCount{ 0 };          //the processor's restored states count when its pattern was last shown
 
     //to implement these I will need to make several getter functions
     juce::TextButton addVisibleRow{ "add one to visibleRows" },
@@ -30,9 +42,14 @@ private:
                      setRepeats{ "setRepeats" },
                      insertColumn{ "insertColumn" },
                      removeColumn{ "removeColumn" },
-                     setColumns{ "setColumns" };
+                     setColumns{ "setColumns" },
+                     bounce{ "bounce" },
+                     morphColumns{ "morphColumns" };    //shows whether the processor morphs the columns, and turns it on or off
 
     void prepare(juce::Button& button);
 
+    //shows a state the processor has restored on the tilt panel
+    void showRestoredState();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TestAudioProcessorEditor)
 };
\ No newline at end of file
@@ -14,10 +14,23 @@ TestAudioProcessor::TestAudioProcessor()
                        )
 #endif
 {
+    addParameter(tilt = new juce::AudioParameterFloat(juce::ParameterID{ "tilt", 1 }, "Tilt", 0.f, 1.f, 0.f));
+    addParameter(useDrumSampler = new juce::AudioParameterBool(juce::ParameterID{ "useDrumSampler", 1 }, "Drum Sampler", true));
+    addParameter(record = new juce::AudioParameterBool(juce::ParameterID{ "record", 1 }, "Record", false));
+    addParameter(morphColumns = new juce::AudioParameterBool(juce::ParameterID{ "morphColumns", 1 }, "Morph Columns", true));
+
+    //the grids belong to the processor, so a restored session is played morphed even if the editor is never opened
+    alphaGrid = TiltMorph::makeEvenGrid(CONSTANTS::ALPHA_GRID_COLUMNS);
+    betaGrid = TiltMorph::makeEvenGrid(CONSTANTS::BETA_GRID_COLUMNS);
+    updateTiltMorph();
+    updateSavedState();
+
+    startTimerHz(30);
 }
 
 TestAudioProcessor::~TestAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -85,8 +98,10 @@ void TestAudioProcessor::changeProgramName (int index, const juce::String& newNa
 //==============================================================================
 void TestAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
+    juce::ignoreUnused(samplesPerBlock);
+
+    patternPlayer.prepare(sampleRate);
+    drumSampler.prepare(sampleRate);
 }
 
 void TestAudioProcessor::releaseResources()
@@ -136,18 +151,166 @@ void TestAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::M
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    const auto& schedule{ patternExchange.acquire() };
+    patternPlayer.setTilt(tilt->get());
+
+    //the note-ons coming in are told apart from the pattern's own by being collected before the pattern is played
+    const auto isRecording{ record->get() };
+    if (isRecording)
+        patternRecorder.collectNoteOns(midiMessages);
+
+    if (const auto transport{ PatternPlayer::getHostTransport(getPlayHead()) })
+        patternPlayer.renderNextBlock(schedule, *transport, midiMessages, 0, buffer.getNumSamples());
+    else
+        patternPlayer.renderNextBlock(schedule, midiMessages, 0, buffer.getNumSamples());
+
+    if (isRecording)
+        patternRecorder.quantizeNoteOns(patternPlayer, schedule);
+
+    if (useDrumSampler->get())
+        drumSampler.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    else
+        drumSampler.stopAllVoices();
+}
+
+void TestAudioProcessor::publishPattern()
+{
+    //a new empty pattern is what is played before anything is published, so that needn't be published either
+    if (pattern.getVersion() == publishedPatternVersion && tiltMorph.getVersion() == publishedMorphVersion)
+        return;
+
+    publishedPatternVersion = pattern.getVersion();
+    publishedMorphVersion = tiltMorph.getVersion();
+
+    patternExchange.publish(pattern, tiltMorph);
+}
+
+void TestAudioProcessor::setTiltGrids(juce::Array<PatternModel::Tick> newAlphaGrid, juce::Array<PatternModel::Tick> newBetaGrid)
+{
+    alphaGrid = std::move(newAlphaGrid);
+    betaGrid = std::move(newBetaGrid);
+    updateTiltMorph();
+}
+
+void TestAudioProcessor::setMorphColumns(const bool& shouldMorphColumns)
+{
+    *morphColumns = shouldMorphColumns;
+    updateTiltMorph();
+}
+
+void TestAudioProcessor::updateTiltMorph()
+{
+    //setGrids() leaves the version alone if the grids are the same, so nothing is published again for nothing
+    if (morphColumns->get())
+        tiltMorph.setGrids(alphaGrid, betaGrid);
+    else
+        tiltMorph.setGrids({}, {});
+
+    publishPattern();
+}
+
+void TestAudioProcessor::timerCallback()
+{
+    applyRestoredState();
+
+    //the host turned morphColumns on or off
+    if (morphColumns->get() != tiltMorph.isActive())
+        updateTiltMorph();
+
+    const auto recordHit{ [this](const PatternRecorder::Hit& hit)
+        {
+            if (canRecordIntoRow && !canRecordIntoRow(hit.row))
+            {
+                heldHits.push_back(hit);
+                return;
+            }
+
+            if (pattern.recordNote(hit.row, hit.column, hit.columnsSize) && onNoteRecorded)
+                onNoteRecorded(hit.row, hit.column);
+        } };
+
+    //the held hits are taken first so they are recorded in the order they were played, those still held back go back in
+    auto hitsToRetry{ std::move(heldHits) };
+    heldHits.clear();
+
+    for (const auto& hit : hitsToRetry)
+        recordHit(hit);
+
+    patternRecorder.takeHits(recordHit);
+
+    //nothing is published unless a note was recorded
+    publishPattern();
+    updateSavedState();
+}
+
+void TestAudioProcessor::updateSavedState()
+{
+    //record isn't saved, a restored instance never starts out recording
+    session.tilt = tilt->get();
+    session.useDrumSampler = useDrumSampler->get();
+    session.morphColumns = morphColumns->get();
+
+    if (PatternState::isUpToDate(pattern, session, stateCache))
+        return;
+
     {
-        auto* channelData = buffer.getWritePointer (channel);
+        const juce::ScopedLock lock(stateLock);
+        if (restoredPattern != nullptr)
+            return;
+    }
+
+    //encoded outside the lock, so a host asking for the state meanwhile only waits for the swap
+    juce::MemoryBlock state;
+    PatternState::write(pattern, session, stateCache, state);
 
-        // ..do something to the data...
+    const juce::ScopedLock lock(stateLock);
+    if (restoredPattern == nullptr)
+        savedState.swapWith(state);
+}
+
+void TestAudioProcessor::applyRestoredState()
+{
+    std::unique_ptr<PatternModel> restored;
+    PatternState::Session decodedSession;
+
+    {
+        const juce::ScopedLock lock(stateLock);
+        restored = std::move(restoredPattern);
+        decodedSession = restoredSession;
     }
+
+    if (restored == nullptr)
+        return;
+
+    pattern.assign(*restored);
+    session = decodedSession;
+
+    *tilt = session.tilt;
+    *useDrumSampler = session.useDrumSampler;
+    *morphColumns = session.morphColumns;
+
+    updateTiltMorph();
+    ++restoredStatesCount;
+}
+
+bool TestAudioProcessor::bouncePattern(const int& bars, const juce::File& midiFile, const juce::File& wavFile)
+{
+    if (patternBouncer == nullptr)
+        patternBouncer = std::make_unique<PatternBouncer>();
+
+    PatternBouncer::Settings settings;
+    settings.bars = bars;
+    settings.beatsPerMinute = patternPlayer.getBeatsPerMinute();
+    settings.tilt = getTilt();
+    settings.sampleRate = getSampleRate() > 0.0 ? getSampleRate() : settings.sampleRate;
+
+    const auto bounce{ patternBouncer->render(pattern, tiltMorph, settings, useDrumSampler->get() ? drumSampler.getSamples(settings.sampleRate)
+                                                                                                 : DrumSampler::Samples{}) };
+
+    if (!PatternBouncer::writeMidiFile(bounce, settings.beatsPerMinute, midiFile))
+        return false;
+
+    return bounce.audio.getNumSamples() == 0 || PatternBouncer::writeWavFile(bounce, settings.sampleRate, wavFile);
 }
 
 //==============================================================================
@@ -164,15 +327,33 @@ juce::AudioProcessorEditor* TestAudioProcessor::createEditor()
 //==============================================================================
 void TestAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    //on the message thread the state can include edits made since the timer last encoded it
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        updateSavedState();
+
+    const juce::ScopedLock lock(stateLock);
+    destData = savedState;
 }
 
 void TestAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    //a state which can't be read, e.g. one saved by a later version, leaves the instance as it was
+    auto restored{ std::make_unique<PatternModel>() };
+    PatternState::Session decodedSession;
+    if (!PatternState::read(data, sizeInBytes, *restored, decodedSession))
+        return;
+
+    {
+        const juce::ScopedLock lock(stateLock);
+        restoredPattern = std::move(restored);
+        restoredSession = decodedSession;
+
+        //so the state handed out before this one is applied is this one
+        savedState.replaceAll(data, static_cast<size_t>(sizeInBytes));
+    }
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        applyRestoredState();
 }
 
 //==============================================================================
@@ -1,11 +1,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PatternModel.h"
+#include "PatternExchange.h"
+#include "PatternPlayer.h"
+#include "TiltMorph.h"
+#include "DrumSampler.h"
+#include "PatternBouncer.h"
+#include "PatternRecorder.h"
+#include "PatternState.h"
 
 //==============================================================================
 /**
 */
 class TestAudioProcessor  : public juce::AudioProcessor
+                          , private juce::Timer
 {
 public:
     //==============================================================================
@@ -42,10 +51,100 @@ public:
     void changeProgramName (int index, const juce::String& newName) override;
 
     //==============================================================================
+    //hosts may call these from any thread, so neither touches pattern or session off the message thread. the state handed
+    //out is the one last encoded on the message thread (see updateSavedState()), and a state restored is decoded where it
+    //is handed in and applied on the message thread (see applyRestoredState())
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    //message thread only: returns the pattern, which the editor views and edits in place, and which outlives the editor
+    PatternModel& getPattern() { return pattern; };
+
+    //message thread only: makes the pattern as it is now the one played from the next block on, unless it and the tilt
+    //grids haven't changed since it last was
+    void publishPattern();
+
+    //message thread only: the rows visible on the tilt panel are saved with the state so they are shown again when it is restored
+    void setVisibleWindow(const int& referenceRow, const int& visibleRows) { session.referenceRow = referenceRow; session.visibleRows = visibleRows; };
+
+    int getReferenceRow() const { return session.referenceRow; };
+
+    int getVisibleRows() const { return session.visibleRows; };
+
+    //returns a number which changes every time setStateInformation() restores a state, so an open editor knows to show it
+    int getRestoredStatesCount() const { return restoredStatesCount; };
+
+    //message thread only: sets the grids the tilt pattern's columns are morphed between (see TiltMorph::setGrids()) and
+    //publishes the pattern morphed between them, if they changed. the processor starts out with even grids of
+    //CONSTANTS::ALPHA_GRID_COLUMNS and CONSTANTS::BETA_GRID_COLUMNS columns
+    void setTiltGrids(juce::Array<PatternModel::Tick> newAlphaGrid, juce::Array<PatternModel::Tick> newBetaGrid);
+
+    //returns true if the columns are morphed between the tilt grids, otherwise they are played at the pattern's own start
+    //positions, which is when those can be edited (see SequencerPanel::shiftStartPositions())
+    bool getMorphColumns() const { return morphColumns->get(); };
+
+    //message thread only: turns morphing the columns on or off, and publishes the pattern played the new way
+    void setMorphColumns(const bool& shouldMorphColumns);
+
+    const TiltMorph& getTiltMorph() const { return tiltMorph; };
+
+    //returns the current value of the tilt parameter, in the range [0, 1]
+    float getTilt() const { return tilt->get(); };
+
+    //message thread only: assigns the sample in file to row of the internal drum sampler, returns false if it can't be read
+    bool loadDrumSample(const int& row, const juce::File& file) { return drumSampler.loadSample(row, file); };
+
+    //message thread only: renders bars bars of the pattern offline, at the current tilt and tempo, to a MIDI file at midiFile
+    //and, if the drum sampler is on, to a WAV file at wavFile. returns false if either can't be written
+    bool bouncePattern(const int& bars, const juce::File& midiFile, const juce::File& wavFile);
+
+    //message thread only: called with the (row, column) of every note recorded into the pattern, so an open editor can show it
+    std::function<void(const int& row, const int& column)> onNoteRecorded;
+
+    //message thread only: notes aren't recorded into any row this returns false for, they are held back until it returns
+    //true (e.g. until an open editor stops dragging a cell in the row). every row is recorded into if it isn't set
+    std::function<bool(const int& row)> canRecordIntoRow;
+
 private:
     //==============================================================================
+    PatternExchange patternExchange;    //hands the pattern published by the editor to processBlock(), compiled into a PatternSchedule
+    PatternPlayer patternPlayer;        //plays the PatternSchedule into the MidiBuffer in processBlock()
+    TiltMorph tiltMorph;                //compiled into every published PatternSchedule, so moving tilt costs nothing here, inactive unless morphColumns is on
+    juce::Array<PatternModel::Tick> alphaGrid, betaGrid;    //message thread only: the grids tiltMorph morphs between while morphColumns is on
+    juce::AudioParameterBool* morphColumns;                 //morphs the columns between the tilt grids, otherwise they are at the pattern's start positions
+    juce::AudioParameterFloat* tilt;    //morphs the columns of the pattern from the alpha grid (0) to the beta grid (1), owned by the processor
+    DrumSampler drumSampler;            //voices the pattern's MIDI into the audio output in processBlock()
+    juce::AudioParameterBool* useDrumSampler;   //the pattern's MIDI is always sent to the host, this turns the internal drum sampler on too
+    std::unique_ptr<PatternBouncer> patternBouncer;     //made the first time a pattern is bounced, so its threads only exist if they are used
+    PatternRecorder patternRecorder;                    //quantizes incoming note-ons into hits, which timerCallback() writes into pattern
+    juce::AudioParameterBool* record;                   //incoming note-ons are only recorded while this is on
+    std::vector<PatternRecorder::Hit> heldHits;         //message thread only: the hits canRecordIntoRow() held back, retried every timerCallback()
+    PatternModel pattern;                               //message thread only: the pattern, edited by the editor while it is open, and saved with the state
+    std::uint32_t publishedPatternVersion{ 0 };         //the version of pattern when it was last published
+    std::uint32_t publishedMorphVersion{ 0 };           //the version of tiltMorph when pattern was last published
+    PatternState::Session session;                      //message thread only: the rest of what is saved, the parameters are copied in when it is
+    PatternState::Cache stateCache;                     //message thread only: so saving only encodes the rows of pattern edited since it was last saved
+    int restoredStatesCount{ 0 };                       //message thread only: incremented by every state restored by applyRestoredState()
+    juce::CriticalSection stateLock;                    //guards savedState, restoredPattern and restoredSession, which any thread may reach
+    juce::MemoryBlock savedState;                       //the state getStateInformation() hands out, encoded on the message thread
+    std::unique_ptr<PatternModel> restoredPattern;      //the pattern setStateInformation() decoded, until it is applied, nullptr if none is waiting
+    PatternState::Session restoredSession;              //the session setStateInformation() decoded with restoredPattern
+
+    //message thread only: encodes pattern and session into savedState, unless they haven't changed since they last were
+    //or a restored state is waiting to be applied (which is what savedState is then)
+    void updateSavedState();
+
+    //message thread only: replaces pattern and session with the ones setStateInformation() last decoded, if any are waiting
+    void applyRestoredState();
+
+    //message thread only: gives tiltMorph the tilt grids if morphColumns is on, or none if it is off, and publishes the
+    //pattern if that changed it. the host may change morphColumns on any thread, so timerCallback() calls this when it has
+    void updateTiltMorph();
+
+    //applies any restored state, writes the hits patternRecorder has queued (and any held back before) into pattern and
+    //publishes it, whether or not an editor is open, so the queue never fills and drops them, then brings savedState up to date
+    void timerCallback() override;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TestAudioProcessor)
 };
@@ -0,0 +1,132 @@
+#include "SampleStreamer.h"
+
+SampleStreamer::SampleStreamer(std::function<void()> onStreamsServiced)
+    : juce::Thread("Sample Streamer"), onStreamsServiced(std::move(onStreamsServiced))
+{
+    for (auto& stream : streams)
+        stream.frames.setSize(DrumSample::maxChannels, streamFrames + 1);
+
+    startThread();
+}
+
+SampleStreamer::~SampleStreamer()
+{
+    shutDown();
+}
+
+void SampleStreamer::shutDown()
+{
+    stopThread(1000);
+}
+
+int SampleStreamer::startStream(const DrumSample& sample, const int& firstFrame)
+{
+    for (auto index{ 0 }; index != numberOfStreams; ++index)
+    {
+        auto& stream{ streams[static_cast<size_t>(index)] };
+
+        if (stream.state.load(std::memory_order_acquire) != idle)
+            continue;
+
+        stream.sample = &sample;
+        stream.nextFrame = firstFrame;
+        stream.state.store(requested, std::memory_order_release);
+
+        return index;
+    }
+
+    return -1;
+}
+
+int SampleStreamer::getNumReady(const int& stream) const
+{
+    const auto& thisStream{ streams[static_cast<size_t>(stream)] };
+
+    //the ring buffer belongs to the streaming thread until it has been reset for this stream
+    if (thisStream.state.load(std::memory_order_acquire) != streaming)
+        return 0;
+
+    return thisStream.fifo.getNumReady();
+}
+
+void SampleStreamer::mixFrames(const int& stream, juce::AudioBuffer<float>& buffer, const int& startSample, const int& numFrames, const float& gain)
+{
+    auto& thisStream{ streams[static_cast<size_t>(stream)] };
+    const auto sampleChannels{ thisStream.sample->getNumChannels() };
+
+    int start1, size1, start2, size2;
+    thisStream.fifo.prepareToRead(numFrames, start1, size1, start2, size2);
+    jassert(size1 + size2 == numFrames);
+
+    for (auto channel{ 0 }; channel != buffer.getNumChannels(); ++channel)
+    {
+        const auto* frames{ thisStream.frames.getReadPointer(juce::jmin(channel, sampleChannels - 1)) };
+        auto* destination{ buffer.getWritePointer(channel, startSample) };
+
+        juce::FloatVectorOperations::addWithMultiply(destination, frames + start1, gain, size1);
+        juce::FloatVectorOperations::addWithMultiply(destination + size1, frames + start2, gain, size2);
+    }
+
+    thisStream.fifo.finishedRead(size1 + size2);
+}
+
+void SampleStreamer::releaseStream(const int& stream)
+{
+    streams[static_cast<size_t>(stream)].state.store(released, std::memory_order_release);
+}
+
+void SampleStreamer::run()
+{
+    while (!threadShouldExit())
+    {
+        for (auto& stream : streams)
+            serviceStream(stream);
+
+        onStreamsServiced();
+
+        wait(passIntervalMs);
+    }
+}
+
+void SampleStreamer::serviceStream(Stream& stream)
+{
+    switch (stream.state.load(std::memory_order_acquire))
+    {
+    case requested:
+    {
+        //the audio thread doesn't touch the ring buffer until the stream is streaming, so it can be emptied here. the audio
+        //thread may have released the stream in the meantime, in which case it is made idle on the next pass
+        stream.fifo.reset();
+
+        auto expectedState{ static_cast<int>(requested) };
+        if (!stream.state.compare_exchange_strong(expectedState, streaming, std::memory_order_acq_rel))
+            return;
+
+        break;
+    }
+
+    case released:
+        stream.state.store(idle, std::memory_order_release);
+        return;
+
+    case streaming:
+        break;
+
+    default:
+        return;
+    }
+
+    const auto& sample{ *stream.sample };
+    const auto numFrames{ juce::jmin(stream.fifo.getFreeSpace(), maxFramesPerRead, sample.getLength() - stream.nextFrame) };
+    if (numFrames <= 0)
+        return;
+
+    int start1, size1, start2, size2;
+    stream.fifo.prepareToWrite(numFrames, start1, size1, start2, size2);
+
+    sample.readFrames(stream.nextFrame, scratch, stream.frames, start1, size1);
+    sample.readFrames(stream.nextFrame + size1, scratch, stream.frames, start2, size2);
+
+    stream.fifo.finishedWrite(size1 + size2);
+    stream.nextFrame += size1 + size2;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include "DrumSample.h"
+
+//streams the tails of DrumSamples to the audio thread. the audio thread starts a stream when a voice starts on a streamed
+//sample, and a background thread reads the sample ahead of it into the stream's ring buffer, so the audio thread only ever
+//reads frames which are already in memory. streams are preallocated and handed between the threads through an atomic state,
+//so neither thread waits for the other:
+//  idle -> (audio thread) requested -> (streaming thread) streaming -> (audio thread) released -> (streaming thread) idle
+class SampleStreamer : private juce::Thread
+{
+public:
+    //onStreamsServiced is called on the streaming thread after every pass over the streams. anything a released stream's
+    //sample was kept alive by can be freed there, since the streaming thread won't read from it again
+    explicit SampleStreamer(std::function<void()> onStreamsServiced);
+
+    ~SampleStreamer() override;
+
+    //stops the streaming thread, after which no more streams are filled and onStreamsServiced is no longer called
+    void shutDown();
+
+    //audio thread only: starts a stream of sample from firstFrame, returns the stream or -1 if every stream is busy.
+    //sample must stay alive until the stream is released and onStreamsServiced has been called after that
+    int startStream(const DrumSample& sample, const int& firstFrame);
+
+    //audio thread only: returns the number of frames stream has ready to be mixed
+    int getNumReady(const int& stream) const;
+
+    //audio thread only: adds the next numFrames frames of stream times gain into buffer from startSample, numFrames must
+    //not be more than getNumReady(). a mono sample is added to every channel
+    void mixFrames(const int& stream, juce::AudioBuffer<float>& buffer, const int& startSample, const int& numFrames, const float& gain);
+
+    //audio thread only: hands stream back to be reused
+    void releaseStream(const int& stream);
+
+    static constexpr int numberOfStreams{ 128 };       //enough for every voice of DrumSampler, with spares for streams waiting to be freed
+    static constexpr int streamFrames{ 16384 };        //the size of each ring buffer, so how far ahead of a voice its stream can read
+    static constexpr int maxFramesPerRead{ 4096 };     //the most a stream is filled by in one pass, so one stream can't hold up the others
+    static constexpr int passIntervalMs{ 2 };          //how long the streaming thread sleeps between passes
+
+private:
+    enum StreamState
+    {
+        idle = 0,
+        requested = 1,
+        streaming = 2,
+        released = 3
+    };
+
+    struct Stream
+    {
+        std::atomic<int> state{ idle };
+        const DrumSample* sample{ nullptr };                //written by the audio thread before requesting
+        int nextFrame{ 0 };                                 //the next frame to be read, written by the audio thread before requesting
+        juce::AudioBuffer<float> frames;                    //the ring buffer, DrumSample::maxChannels by streamFrames + 1
+        juce::AbstractFifo fifo{ streamFrames + 1 };
+    };
+
+    std::array<Stream, numberOfStreams> streams;
+    std::function<void()> onStreamsServiced;
+    juce::AudioBuffer<float> scratch;                       //streaming thread only, see DrumSample::readFrames()
+
+    void run() override;
+
+    //streaming thread only: moves stream on from requested or released, and fills it if it is streaming
+    void serviceStream(Stream& stream);
+};
@@ -1,12 +1,14 @@
 #include "SequencerCell.h"
 
-SequencerCell::SequencerCell()
+SequencerCell::SequencerCell(CellSpriteCache& spriteCacheToPaintWith)
+    : spriteCache(spriteCacheToPaintWith)
 {
     setInterceptsMouseClicks(false, false);
 }
 
 SequencerCell::SequencerCell(const SequencerCell& cell)
-    : state{ cell.getState() }
+    : spriteCache(cell.spriteCache)
+    , state{ cell.getState() }
     , isLeftConnected{ cell.getIsLeftConnected() }
     , isRightConnected{ cell.getIsRightConnected() }
 {
@@ -26,18 +28,23 @@ SequencerCell* SequencerCell::setCell(const SequencerCell& cell)
 
 
 void SequencerCell::paint(juce::Graphics& g)
+{
+    spriteCache.drawCell(g, getLocalBounds(), isOn(), isLeftConnected, isRightConnected, isSelected, mouseIsOverCell);
+}
+
+void SequencerCell::paintCell(juce::Graphics& g, const juce::Rectangle<int>& bounds, const State& state,
+    const bool& isLeftConnected, const bool& isRightConnected, const bool& isSelected, const bool& mouseIsOverCell)
 {
     using namespace juce;
-    const auto localBounds{ getLocalBounds() };
 
     Path outline;
     const auto outlineReduction{ 2 };
     const auto cornerSize{ 3 };
-    outline.addRoundedRectangle(!isLeftConnected * outlineReduction - isLeftConnected,
-        outlineReduction,
-        localBounds.getWidth() - (!isLeftConnected + !isRightConnected) * outlineReduction
+    outline.addRoundedRectangle(bounds.getX() + !isLeftConnected * outlineReduction - isLeftConnected,
+        bounds.getY() + outlineReduction,
+        bounds.getWidth() - (!isLeftConnected + !isRightConnected) * outlineReduction
         + isLeftConnected + isRightConnected,
-        localBounds.getHeight() - 2 * outlineReduction,
+        bounds.getHeight() - 2 * outlineReduction,
         cornerSize, cornerSize,
         !isLeftConnected, !isRightConnected,
         !isLeftConnected, !isRightConnected);
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "CellSpriteCache.h"
 
 //a simple class representing a cell in Sequencer Pannel and Strip
 class SequencerCell : public juce::Component
@@ -12,12 +13,17 @@ public:
         on = 1
     };
 
-    SequencerCell();
+    //spriteCacheToPaintWith is the cache of whatever owns the cell, and must outlive it
+    explicit SequencerCell(CellSpriteCache& spriteCacheToPaintWith);
 
     SequencerCell(const SequencerCell& cell);
 
     void paint(juce::Graphics& g) override;
 
+    //rasterises a cell with these properties into bounds, CellSpriteCache uses this to render its sprites
+    static void paintCell(juce::Graphics& g, const juce::Rectangle<int>& bounds, const State& state,
+        const bool& isLeftConnected, const bool& isRightConnected, const bool& isSelected, const bool& mouseIsOverCell);
+
     SequencerCell* setCell(const SequencerCell& cell);
 
     SequencerCell* setIsLeftConnected(const bool& shouldBeConnected)
@@ -70,9 +76,11 @@ public:
 
     void setIsSelected(const bool& shouldBeSelected) { isSelected = shouldBeSelected; };
 
-    const int edgeWidth{ 3 };
+    static constexpr int edgeWidth{ 3 };
 
 private:
+    CellSpriteCache& spriteCache;   //the owner's, so making a cell doesn't take a reference to the shared cache of its own
+
     State state{ off };
 
     bool mouseIsOverCell{ false },
@@ -0,0 +1,47 @@
+#include "SequencerCellPool.h"
+
+SequencerCellPool::~SequencerCellPool()
+{
+    for (size_t slab{ 0 }; slab != slabs.size(); ++slab)
+    {
+        const auto constructed{ slab + 1 == slabs.size() ? constructedInLastSlab : cellsPerSlab };
+
+        for (auto index{ 0 }; index != constructed; ++index)
+            std::launder(reinterpret_cast<SequencerCell*>(slabs[slab][static_cast<size_t>(index)].bytes))->~SequencerCell();
+    }
+}
+
+SequencerCell* SequencerCellPool::acquire()
+{
+    if (!freeCells.empty())
+    {
+        const auto cell{ freeCells.back() };
+        freeCells.pop_back();
+
+        return cell;
+    }
+
+    //not value initialised, the storage is only written by constructing cells in it
+    if (constructedInLastSlab == cellsPerSlab)
+    {
+        slabs.emplace_back(new CellStorage[static_cast<size_t>(cellsPerSlab)]);
+        constructedInLastSlab = 0;
+    }
+
+    const auto cell{ new (slabs.back()[static_cast<size_t>(constructedInLastSlab)].bytes) SequencerCell(spriteCache) };
+    ++constructedInLastSlab;
+
+    return cell;
+}
+
+void SequencerCellPool::release(SequencerCell* cell)
+{
+    jassert(cell != nullptr && cell->getParentComponent() == nullptr);
+
+    //as a cell fresh from a slab is
+    cell->turnOff()->setMouseIsOverCell(false);
+    cell->setIsSelected(false);
+    cell->setVisible(false);
+
+    freeCells.push_back(cell);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SequencerCell.h"
+
+//hands out SequencerCells from slabs of storage for cellsPerSlab cells, so growing the repeats or inserting a column allocates
+//once per slab rather than once (or twice, with a shared_ptr) per cell. a slab is only raw storage, each cell in it is
+//constructed the first time it is handed out, so a panel showing a few cells doesn't construct a slab's worth of components.
+//a cell's address never changes while the pool exists, and a released cell goes on a free list to be handed out again in
+//O(1). each SequencerPanel has its own pool, so panels never share one. only componentRendering has SequencerCells, so only
+//it uses the pool. message thread only
+class SequencerCellPool
+{
+public:
+    //the cells are painted with spriteCacheForCells, which must outlive the pool
+    explicit SequencerCellPool(CellSpriteCache& spriteCacheForCells) : spriteCache(spriteCacheForCells) {};
+
+    ~SequencerCellPool();
+
+    //returns a cell which is off, disconnected, hidden and not under the mouse, allocating a slab if every cell in the
+    //slabs has been constructed and none are free
+    SequencerCell* acquire();
+
+    //gives cell back to be handed out again, it must have come from this pool and no longer be a child of any component
+    void release(SequencerCell* cell);
+
+    //returns the number of cells the slabs have storage for, constructed or not
+    int getCapacity() const { return static_cast<int>(slabs.size()) * cellsPerSlab; };
+
+    static constexpr int cellsPerSlab{ 256 };
+
+private:
+    //room for one cell, which is constructed in it the first time it is handed out
+    struct CellStorage
+    {
+        alignas(SequencerCell) std::byte bytes[sizeof(SequencerCell)];
+    };
+
+    CellSpriteCache& spriteCache;                           //the panel's, which every cell is painted with
+    std::vector<std::unique_ptr<CellStorage[]>> slabs;
+    int constructedInLastSlab{ cellsPerSlab };              //the number of cells constructed in the last slab, the others are full
+    std::vector<SequencerCell*> freeCells;                  //the constructed cells not handed out, the next to be handed out last
+
+    JUCE_DECLARE_NON_COPYABLE(SequencerCellPool)
+};
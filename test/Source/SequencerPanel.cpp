@@ -1,81 +1,62 @@
 #include "SequencerPanel.h"
 
-SequencerPanel::SequencerPanel(const int& initialVisibleRows)
-    : numberOfVisibleRows(initialVisibleRows > 0 ? initialVisibleRows : 1 )
+SequencerPanel::SequencerPanel(PatternModel& patternToView, const int& initialVisibleRows, const RenderingMode& initialRenderingMode)
+    : pattern(patternToView)
+    , renderingMode(initialRenderingMode)
+    , numberOfVisibleRows(initialVisibleRows > 0 ? initialVisibleRows : 1 )
 {
     initialiseSequencerPanelInvariants();
 
-    for (auto row{0}; row != rowsSize(); ++row)
-        handleAdditionOfCellToPattern(row, std::shared_ptr<SequencerCell>(new SequencerCell));
+    //the pattern may have been edited long before the panel was made to view it, but not by the panel
+    notifiedPatternVersion = pattern.getVersion();
 
-    grid.templateColumns.add(grid.autoColumns);
     setTemplateRows(numberOfVisibleRows);
-    handleFillingGridItems(numberOfVisibleRows);
+    layOutColumns();
+
+    if (renderingMode == componentRendering)
+        createCells();
 }
 
 SequencerPanel::SequencerPanel(const SequencerPanel& otherSequencerPanel)
-    : numberOfVisibleRows(otherSequencerPanel.numberOfVisibleRows)
+    : pattern(otherSequencerPanel.pattern)
+    , renderingMode(otherSequencerPanel.renderingMode)
+    , numberOfVisibleRows(otherSequencerPanel.numberOfVisibleRows)
 {
     initialiseSequencerPanelInvariants();
 
     handShallowCopying(otherSequencerPanel);
 
     //deep copy stuff--------------------------------------------------------
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-    {
-        pattern[row].reserve(otherSequencerPanel.columnsSize());
-
-        for (auto& cell : otherSequencerPanel.pattern[row])
-            handleAdditionOfCellToPattern(row, std::shared_ptr<SequencerCell>(new SequencerCell(*cell)));
-    }
-
-    handleFillingGridItems(numberOfVisibleRows);
+    if (renderingMode == componentRendering)
+        createCells();
 }
 
 SequencerPanel::SequencerPanel(SequencerPanel&& otherSequencerPanel) noexcept
-    : numberOfVisibleRows(otherSequencerPanel.numberOfVisibleRows)
+    : pattern(otherSequencerPanel.pattern)
+    , renderingMode(otherSequencerPanel.renderingMode)
+    , numberOfVisibleRows(otherSequencerPanel.numberOfVisibleRows)
 {
     initialiseSequencerPanelInvariants();
 
     handShallowCopying(otherSequencerPanel);
 
-    //deep copy stuff--------------------------------------------------------
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-    {
-        auto& thisRow{ pattern[row] };
-
-        thisRow.clear();
-        thisRow.reserve(otherSequencerPanel.columnsSize());
-
-        auto& otherRow{ otherSequencerPanel.pattern[row] };
-
-        thisRow = otherRow;
-
-        otherRow.clear();
-    }
-
-    handleFillingGridItems(numberOfVisibleRows);
+    //the other panel's SequencerCells are its children, so this panel makes its own
+    if (renderingMode == componentRendering)
+        createCells();
 }
 
 SequencerPanel& SequencerPanel::operator=(SequencerPanel otherSequencerPanel)
 {
     if (this != &otherSequencerPanel)
     {
+        destroyCells();
         handShallowCopying(otherSequencerPanel);
 
         //deep copy stuff--------------------------------------------------------
-        for (auto row{ 0 }; row != rowsSize(); ++row)
-        {
-            auto& thisRow{ pattern[row] };
-
-            thisRow.clear();
-            thisRow.reserve(otherSequencerPanel.columnsSize());
+        if (renderingMode == componentRendering)
+            createCells();
 
-            for (auto& cell : otherSequencerPanel.pattern[row])
-                handleAdditionOfCellToPattern(row, std::shared_ptr<SequencerCell>(new SequencerCell(*cell)));
-        }
-
-        handleFillingGridItems(numberOfVisibleRows);
+        resized();
     }
 
     return *this;
@@ -85,24 +66,14 @@ SequencerPanel& SequencerPanel::operator=(SequencerPanel&& otherSequencerPanel)
 {
     if (this != &otherSequencerPanel)
     {
+        destroyCells();
         handShallowCopying(otherSequencerPanel);
 
-        //deep copy stuff--------------------------------------------------------
-        for (auto row{ 0 }; row != rowsSize(); ++row)
-        {
-            auto& thisRow{ pattern[row] };
-
-            thisRow.clear();
-            thisRow.reserve(otherSequencerPanel.columnsSize());
-
-            auto& otherRow{ otherSequencerPanel.pattern[row] };
-
-            thisRow = otherRow;
+        //the other panel's SequencerCells are its children, so this panel makes its own
+        if (renderingMode == componentRendering)
+            createCells();
 
-            otherRow.clear();
-        }
-
-        handleFillingGridItems(numberOfVisibleRows);
+        resized();
     }
 
     return *this;
@@ -122,6 +93,39 @@ void SequencerPanel::initialiseSequencerPanelInvariants()
 void SequencerPanel::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::black);
+
+    if (renderingMode == virtualisedRendering)
+        paintVisibleCells(g);
+}
+
+void SequencerPanel::paintVisibleCells(juce::Graphics& g) const
+{
+    if (!offsetsAreUpToDate())
+        return;
+
+    //only the columns and rows overlapping the clip region are painted
+    const auto clipBounds{ g.getClipBounds() };
+    const auto [firstColumn, lastColumn] { columnLayout.findColumnsOverlapping(clipBounds.getX(), clipBounds.getRight()) };
+    const auto [firstVisibleRow, lastVisibleRow] { ColumnLayout::findSpansOverlapping(rowOffsets, clipBounds.getY(), clipBounds.getBottom()) };
+
+    for (auto visibleRow{ firstVisibleRow }; visibleRow < lastVisibleRow; ++visibleRow)
+    {
+        //visible rows are counted from the top, whereas rows in pattern are counted from the bottom
+        const auto row{ getVisibleRowsMax() - visibleRow };
+
+        for (auto column{ firstColumn }; column < lastColumn; ++column)
+        {
+            const auto cell{ pattern.getCell(row, column) };
+            const std::pair<int, int> cellCoordinates{ row, column };
+
+            spriteCache->drawCell(g, getCellBounds(row, column),
+                (cell & PatternModel::onFlag) != 0,
+                (cell & PatternModel::leftConnectedFlag) != 0,
+                (cell & PatternModel::rightConnectedFlag) != 0,
+                selectedCells.contains(cellCoordinates),
+                lastOverCell == cellCoordinates);
+        }
+    }
 }
 
 void SequencerPanel::handleFillingGridItems(const int& newNumberOfVisibleRows)
@@ -132,7 +136,7 @@ void SequencerPanel::handleFillingGridItems(const int& newNumberOfVisibleRows)
     for (auto column{ 0 }; column != columnsSize(); ++column)
         for (auto visibleRow{ newNumberOfVisibleRows - 1 }; visibleRow >= 0; --visibleRow)
         {
-            auto cell{ getCellInPattern(visibleRow + referenceRow, column).get() };
+            auto cell{ getCellInCells(visibleRow + referenceRow, column) };
 
             grid.items.setUnchecked(newNumberOfVisibleRows - 1 - visibleRow + column * newNumberOfVisibleRows, cell);
             cell->setVisible(true);
@@ -146,16 +150,22 @@ void SequencerPanel::setNumberOfVisibleRows(const int& newNumberOfVisibleRows)
 
     setTemplateRows(newNumberOfVisibleRows);
 
-    if (newNumberOfVisibleRows < numberOfVisibleRows)//i.e. there are fewer visible rows on screen
-        for (auto row{ referenceRow + newNumberOfVisibleRows }; row != referenceRow + numberOfVisibleRows; ++row)
-            std::for_each(pattern[row].begin(), pattern[row].end(),[](auto& cell)
-                { cell->setVisible(false); });
+    const auto oldNumberOfVisibleRows{ numberOfVisibleRows };
+    numberOfVisibleRows = newNumberOfVisibleRows;
 
-    handleFillingGridItems(newNumberOfVisibleRows);
+    if (renderingMode == componentRendering)
+    {
+        if (newNumberOfVisibleRows < oldNumberOfVisibleRows)//i.e. there are fewer visible rows on screen
+            for (auto row{ referenceRow + newNumberOfVisibleRows }; row != referenceRow + oldNumberOfVisibleRows; ++row)
+                std::for_each(cells[row].begin(), cells[row].end(),[](auto& cell)
+                    { cell->setVisible(false); });
 
-    numberOfVisibleRows = newNumberOfVisibleRows;
+        moveCellRowsToVisibleRows();
+        handleFillingGridItems(newNumberOfVisibleRows);
+    }
 
-    resized();
+    updateRowOffsets();
+    layOutCells();
 }
 
 void SequencerPanel::setMode(const SequencerMode& newMode)
@@ -210,38 +220,57 @@ void SequencerPanel::enterSelectionMode()
 {
 }
 
-bool SequencerPanel::eventIsContainedByADraggableLeftEdge(const SequencerCell* const cell, const juce::Point<int>& eventPosition) const
+void SequencerPanel::setRenderingMode(const RenderingMode& newRenderingMode)
 {
-    return cell->isOn() && getLeftEdgeBounds(cell).contains(eventPosition) && cell->getIsLeftConnected() == false;
+    if (newRenderingMode == renderingMode)
+        return;
+
+    renderingMode = newRenderingMode;
+
+    if (renderingMode == componentRendering)
+        createCells();
+    else
+        destroyCells();
+
+    resized();
+    repaint();
 }
 
-bool SequencerPanel::eventIsContainedByADraggableRightEdge(const SequencerCell* const cell, const juce::Point<int>& eventPosition) const
+bool SequencerPanel::eventIsContainedByADraggableLeftEdge(const int& row, const int& column, const juce::Point<int>& eventPosition) const
 {
-    return cell->isOn() && getRightEdgeBounds(cell).contains(eventPosition) && cell->getIsRightConnected() == false;
+    return pattern.isOn(row, column) && getLeftEdgeBounds(row, column).contains(eventPosition) && pattern.getIsLeftConnected(row, column) == false;
 }
 
-bool SequencerPanel::eventIsContainedByADraggableEdge(const SequencerCell* const cell, const juce::Point<int>& eventPosition) const
+bool SequencerPanel::eventIsContainedByADraggableRightEdge(const int& row, const int& column, const juce::Point<int>& eventPosition) const
 {
-    return eventIsContainedByADraggableLeftEdge(cell, eventPosition) || eventIsContainedByADraggableRightEdge(cell, eventPosition);
+    return pattern.isOn(row, column) && getRightEdgeBounds(row, column).contains(eventPosition) && pattern.getIsRightConnected(row, column) == false;
 }
 
-void SequencerPanel::updateLastCellOver(SequencerCell* const cell)
+bool SequencerPanel::eventIsContainedByADraggableEdge(const int& row, const int& column, const juce::Point<int>& eventPosition) const
 {
-    if (cell)
-    {
-        exitLastCellOver();
+    return eventIsContainedByADraggableLeftEdge(row, column, eventPosition) || eventIsContainedByADraggableRightEdge(row, column, eventPosition);
+}
 
-        cell->setMouseIsOverCell(true);
-        lastOverCell = cell;
-    }
+void SequencerPanel::updateLastCellOver(const int& row, const int& column)
+{
+    exitLastCellOver();
+
+    lastOverCell = { row, column };
+
+    if (renderingMode == componentRendering)
+        getCellPtr(row, column)->setMouseIsOverCell(true);
+
+    refreshCell(row, column);
 }
 
 void SequencerPanel::resetDraggingStates()
 {
     isDraggingLeftCellEdge = false;
     isDraggingRightCellEdge = false;
-    mouseDownCell = nullptr;
+    lastDragChangedWholeRow = false;
+    mouseDownCell.reset();
     rowSnapshot.clear();
+    rowSnapshotSpans.clear();
 };
 
 void SequencerPanel::mouseUp(const juce::MouseEvent& event)
@@ -249,7 +278,9 @@ void SequencerPanel::mouseUp(const juce::MouseEvent& event)
     if (isDraggingCellEdge())
     {
         setMouseCursor(juce::MouseCursor::NormalCursor);
-        updateLastCellOver(getCellAtLocation(event.getPosition()));
+
+        if (const auto cellCoordinates{ getCellCoordinatesAtLocation(event.getPosition()) })
+            updateLastCellOver(cellCoordinates->first, cellCoordinates->second);
 
         resetDraggingStates();
     }
@@ -267,18 +298,17 @@ void SequencerPanel::mouseMove(const juce::MouseEvent& event)
     {
         setMouseCursor(MouseCursor::LeftRightResizeCursor);
     }
-    else if (const auto cell{ getCellAtLocation(eventPosition) })
+    else if (const auto cellCoordinates{ getCellCoordinatesAtLocation(eventPosition) })
     {
-        if (eventIsContainedByADraggableEdge(cell, eventPosition))
+        const auto& [row, column] = cellCoordinates.value();
+
+        if (eventIsContainedByADraggableEdge(row, column, eventPosition))
             setMouseCursor(MouseCursor::LeftRightResizeCursor);
         else
             setMouseCursor(MouseCursor::NormalCursor);
 
-        if (cell != lastOverCell)
-        {
-            updateLastCellOver(cell);
-            cell->repaint();
-        }
+        if (cellCoordinates != lastOverCell)
+            updateLastCellOver(row, column);
     }
     else
     {
@@ -290,36 +320,37 @@ void SequencerPanel::mouseMove(const juce::MouseEvent& event)
 void SequencerPanel::mouseExit(const juce::MouseEvent& event)
 {
     exitLastCellOver();
-    lastOverCell = nullptr;
 }
 
-SequencerCell* SequencerPanel::changeCellState(SequencerCell* cell)
+void SequencerPanel::changeCellState(const int& row, const int& column)
 {
-    return setCellState(cell, cell->getState() == SequencerCell::State::on ? SequencerCell::State::off
-                                                                  : SequencerCell::State::on);
+    setCellState(row, column, pattern.isOn(row, column) ? SequencerCell::State::off
+                                                        : SequencerCell::State::on);
 }
 
-SequencerCell* SequencerPanel::setCellState(SequencerCell* const cell, const SequencerCell::State& newState)
+void SequencerPanel::setCellState(const int& row, const int& column, const SequencerCell::State& newState)
 {
-    cell->setState(newState);
+    pattern.setState(row, column, newState == SequencerCell::State::on);
 
-    if (cell->getIsLeftConnected() && newState == SequencerCell::State::off)
+    if (pattern.getIsLeftConnected(row, column) && newState == SequencerCell::State::off)
     {
-        cell->setIsLeftConnected(false);
+        pattern.setIsLeftConnected(row, column, false);
 
-        const auto leftCell{ getLeftCell(cell) };
-        leftCell->setIsRightConnected(false)->repaint();
+        const auto leftColumn{ getLeftColumn(column) };
+        pattern.setIsRightConnected(row, leftColumn, false);
+        refreshCell(row, leftColumn);
     }
 
-    if (cell->getIsRightConnected() && newState == SequencerCell::State::off)
+    if (pattern.getIsRightConnected(row, column) && newState == SequencerCell::State::off)
     {
-        cell->setIsRightConnected(false);
+        pattern.setIsRightConnected(row, column, false);
 
-        const auto rightCell{ getRightCell(cell) };
-        rightCell->setIsLeftConnected(false)->repaint();
+        const auto rightColumn{ getRightColumn(column) };
+        pattern.setIsLeftConnected(row, rightColumn, false);
+        refreshCell(row, rightColumn);
     }
 
-    return cell;
+    refreshCell(row, column);
 }
 
 bool SequencerPanel::columnIsWithinBounds(const int& column, const std::pair<int, int>& bounds) const
@@ -341,15 +372,16 @@ void SequencerPanel::mouseDown(const juce::MouseEvent& event)
 
     const auto eventPosition{ event.getPosition() };
 
-    if (const auto cell{ getCellAtLocation(eventPosition) })
+    if (const auto cellCoordinates{ getCellCoordinatesAtLocation(eventPosition) })
     {
-        mouseDownCell = cell;
-        const auto row{ getCellRow(cell) };
-        const auto canDragLeft{ eventIsContainedByADraggableLeftEdge(cell, eventPosition) && row.has_value() }
-        , canDragRight{ eventIsContainedByADraggableRightEdge(cell, eventPosition) && row.has_value() };
+        const auto& [row, column] = cellCoordinates.value();
+
+        mouseDownCell = cellCoordinates;
+        const auto canDragLeft{ eventIsContainedByADraggableLeftEdge(row, column, eventPosition) }
+        , canDragRight{ eventIsContainedByADraggableRightEdge(row, column, eventPosition) };
 
         if (canDragLeft || canDragRight)
-            snapshotRow(row.value());
+            snapshotRow(row);
 
         if (canDragLeft)
         {
@@ -361,150 +393,100 @@ void SequencerPanel::mouseDown(const juce::MouseEvent& event)
         }
         else
         {
-            changeCellState(cell)->repaint();
-            lastCellStateChange = cell->getState();
+            changeCellState(row, column);
+            lastCellStateChange = pattern.isOn(row, column) ? SequencerCell::State::on : SequencerCell::State::off;
         }
     }
 }
 
-juce::Rectangle<int> SequencerPanel::getLeftEdgeBounds(const SequencerCell* const cell) const
+juce::Rectangle<int> SequencerPanel::getCellBounds(const int& row, const int& column) const
 {
-    return getCellColumn(cell) != 0 ? cell->getBoundsInParent().withWidth(cell->edgeWidth)
-        : cell->getBoundsInParent().withWidth(2 * cell->edgeWidth);
-}
+    jassert(offsetsAreUpToDate() && rowIsVisible(row) && column >= 0 && column < columnsSize());
 
-juce::Rectangle<int> SequencerPanel::getRightEdgeBounds(const SequencerCell* const cell) const
-{
-    const auto cellBounds{ cell->getBoundsInParent() };
+    //visible rows are counted from the top, whereas rows in pattern are counted from the bottom
+    const auto visibleRow{ getVisibleRowsMax() - row };
 
-    return getCellColumn(cell) != columnsSize() - 1 ? cellBounds.withTrimmedLeft(cellBounds.getWidth() - cell->edgeWidth)
-        : cellBounds.withTrimmedLeft(cellBounds.getWidth() - 2 * cell->edgeWidth);
+    return { columnLayout.getX(column),
+             rowOffsets[visibleRow],
+             columnLayout.getWidth(column),
+             rowOffsets[visibleRow + 1] - rowOffsets[visibleRow] };
 }
 
-SequencerCell* SequencerPanel::getLeftCell(const SequencerCell* const cell, const int& steps) const
+juce::Rectangle<int> SequencerPanel::getLeftEdgeBounds(const int& row, const int& column) const
 {
-    if (const auto cellCoordinates{ getCellCoordinates(cell) })
-        return getCellPtr(cellCoordinates.value().first, getLeftColumn(cellCoordinates.value().second, steps));
-    else
-        return nullptr;
+    return column != 0 ? getCellBounds(row, column).withWidth(SequencerCell::edgeWidth)
+        : getCellBounds(row, column).withWidth(2 * SequencerCell::edgeWidth);
 }
 
-SequencerCell* SequencerPanel::getRightCell(const SequencerCell* const cell, const int& steps) const
+juce::Rectangle<int> SequencerPanel::getRightEdgeBounds(const int& row, const int& column) const
 {
-    if (const auto cellCoordinates{ getCellCoordinates(cell) })
-        return getCellPtr(cellCoordinates.value().first, getRightColumn(cellCoordinates.value().second, steps));
-    else
-        return nullptr;
-}
+    const auto cellBounds{ getCellBounds(row, column) };
 
-void SequencerPanel::connectWholeRow(const int& row)
-{
-    auto& patternRow{ pattern[row] };
-    for (auto& cell : patternRow)
-        cell->setState(SequencerCell::State::on)->setIsLeftConnected(true)->setIsRightConnected(true);
+    return column != columnsSize() - 1 ? cellBounds.withTrimmedLeft(cellBounds.getWidth() - SequencerCell::edgeWidth)
+        : cellBounds.withTrimmedLeft(cellBounds.getWidth() - 2 * SequencerCell::edgeWidth);
 }
 
-void SequencerPanel::handleDragEdgeOfNonGreaterCell(SequencerCell* const cell, const juce::Point<int> dragPosition)
+void SequencerPanel::handleDragEdgeOfNonGreaterCell(const int& row, const int& cellColumn, const juce::Point<int> dragPosition)
 {
-    const auto row{ getCellRow(cell) };
-
-    if (!row.has_value())
-        return;
-
-    auto& patternRow{ pattern[row.value()] };
-    const auto middleOfCell{ cell->getBoundsInParent().getCentreX() };
+    const auto middleOfCell{ getCellBounds(row, cellColumn).getCentreX() };
 
     if ((isDraggingLeftCellEdge && dragPosition.getX() > middleOfCell) ||
         (isDraggingRightCellEdge && dragPosition.getX() < middleOfCell))
     {
-        for (auto& rowCell : patternRow)
-        {
-            rowCell->setState(SequencerCell::State::on)->setIsLeftConnected(true)->setIsRightConnected(true);
-        }
+        pattern.connectWholeRow(row);
 
         if (isDraggingLeftCellEdge)
         {
-            cell->setIsRightConnected(false);
-            getRightCell(cell)->setIsLeftConnected(false);
+            pattern.setIsRightConnected(row, cellColumn, false);
+            pattern.setIsLeftConnected(row, getRightColumn(cellColumn), false);
         }
         else if (isDraggingRightCellEdge)
         {
-            getLeftCell(cell)->setIsRightConnected(false);
-            cell->setIsLeftConnected(false);
+            pattern.setIsRightConnected(row, getLeftColumn(cellColumn), false);
+            pattern.setIsLeftConnected(row, cellColumn, false);
         }
     }
     else
     {
-        const auto cellColumn{ getCellColumn(cell) };
-        if (!cellColumn.has_value())
-            return;
-
-        const auto snapshotBounds{ getBoundsOfGreaterCellAtColumnInRowSnapshot(cellColumn.value()) };
+        const auto snapshotBounds{ getBoundsOfGreaterCellAtColumnInRowSnapshot(cellColumn) };
         if (!snapshotBounds.has_value())
             return;
 
         for (auto column{ 0 }; column != columnsSize(); ++column)
         {
-            auto& rowCell{ patternRow[column] };
-
-            if (column != cellColumn.value() && columnIsWithinBounds(column, snapshotBounds.value()))
-                rowCell->turnOff();
+            if (column != cellColumn && columnIsWithinBounds(column, snapshotBounds.value()))
+                pattern.turnOff(row, column);
             else
-                rowCell->setCell(*rowSnapshot.getReference(column));
+                restoreCellFromRowSnapshot(row, column);
         }
 
-        patternRow[cellColumn.value()]->setIsLeftConnected(false)->setIsRightConnected(false);
+        pattern.setIsLeftConnected(row, cellColumn, false);
+        pattern.setIsRightConnected(row, cellColumn, false);
     }
-}
 
-std::optional<int> SequencerPanel::getLeftBoundOfGreaterCellContainingCell(const SequencerCell* const cell) const
-{
-    if (!cell->getIsLeftConnected())
-        return getCellColumn(cell);
-    else
-    {
-        auto iteratingCell{ getLeftCell(cell) };
-        while (iteratingCell != cell)
-            if (!iteratingCell->getIsLeftConnected())
-                return getCellColumn(iteratingCell);
-            else
-                iteratingCell = getLeftCell(iteratingCell);
-    }
-
-    return std::nullopt;
+    lastDragChangedWholeRow = true;
 }
 
-std::optional<int> SequencerPanel::getRightBoundOfGreaterCellContainingCell(const SequencerCell* const cell) const
+std::optional<int> SequencerPanel::getLeftBoundOfGreaterCellContainingCell(const int& row, const int& column) const
 {
-    auto iteratingCell{ getRightCell(cell) };
+    if (!pattern.isOn(row, column))
+        return column;
 
-    if (!cell->getIsRightConnected())
-        return getCellColumn(iteratingCell);
-    else
-        while (iteratingCell != cell)
-            if (!iteratingCell->getIsRightConnected())
-                return getCellColumn(getRightCell(iteratingCell));
-            else
-                iteratingCell = getRightCell(iteratingCell);
+    if (const auto noteSpan{ pattern.findNoteSpan(row, column) })
+        return noteSpan->start;
 
     return std::nullopt;
 }
 
-std::optional<std::tuple<int, int, int>> SequencerPanel::getCoordinatesOfGreaterCellContainingCell(const SequencerCell* const cell) const
+std::optional<int> SequencerPanel::getRightBoundOfGreaterCellContainingCell(const int& row, const int& column) const
 {
-    const auto row{ getCellRow(cell) };
-    if (!row.has_value())
-        return std::nullopt;
+    if (!pattern.isOn(row, column))
+        return getRightColumn(column);
 
-    const auto leftBound{ getLeftBoundOfGreaterCellContainingCell(cell) };
-    if (!leftBound.has_value())
-        return std::nullopt;
-
-    const auto rightBound{ getRightBoundOfGreaterCellContainingCell(cell) };
-    if (!rightBound.has_value())
-        return std::nullopt;
+    if (const auto noteSpan{ pattern.findNoteSpan(row, column) })
+        return noteSpan->end(columnsSize());
 
-    return std::make_optional<std::tuple<int, int, int>>(row.value(), leftBound.value(), rightBound.value());
+    return std::nullopt;
 }
 
 void SequencerPanel::mouseDrag(const juce::MouseEvent& event)
@@ -516,47 +498,47 @@ void SequencerPanel::mouseDrag(const juce::MouseEvent& event)
                                                                         .withX(CUSTOM_FUNCTIONS::positiveMod(event.getPosition().getX(), getWidth()))
                                                    : event.getPosition() };
 
-    auto cell{ getCellAtLocation(eventPosition) };
+    const auto cellCoordinates{ getCellCoordinatesAtLocation(eventPosition) };
 
-    if (!cell)
+    if (!cellCoordinates.has_value())
     {
         exitLastCellOver();
         return;
     }
 
+    const auto& [row, column] = cellCoordinates.value();
+
     if (isDraggingCellEdge())
     {
-        const auto mouseDownCellCoordinates{ getCellCoordinates(mouseDownCell) };
-        if (!mouseDownCellCoordinates.has_value())
+        if (!mouseDownCell.has_value())
             return;
 
-        const auto& [snapshotRow, mouseDownColumn] = mouseDownCellCoordinates.value();
+        const auto& [snapshotRow, mouseDownColumn] = mouseDownCell.value();
         const auto currentBounds{ getLiveBoundsOfGreaterCell(snapshotRow, mouseDownColumn) };
-        const auto cellColumn{ getCellColumn(cell) };
 
-        if (!currentBounds.has_value() || !cellColumn.has_value())
+        if (!currentBounds.has_value())
             return;
 
         if (isDraggingLeftCellEdge)
         {
-            handleDraggingLeftCellEdge(cell, eventPosition, snapshotRow,
-                currentBounds.value(), getRightColumn(cellColumn.value()));
+            handleDraggingLeftCellEdge(snapshotRow, column, eventPosition,
+                currentBounds.value(), getRightColumn(column));
         }
         else if (isDraggingRightCellEdge)
         {
-            handleDraggingRightCellEdge(cell, eventPosition, snapshotRow,
-                currentBounds.value(), cellColumn.value());
+            handleDraggingRightCellEdge(snapshotRow, column, eventPosition,
+                currentBounds.value(), column);
         }
     }
     else
     {
-        if (cell == lastOverCell)
+        if (cellCoordinates == lastOverCell)
             return;
 
-        setCellState(cell, lastCellStateChange)->repaint();
+        setCellState(row, column, lastCellStateChange);
     }
 
-    updateLastCellOver(cell);
+    updateLastCellOver(row, column);
 }
 
 std::optional<std::pair<int, int>> SequencerPanel::getLiveBoundsOfGreaterCell(const int& row, const int& column) const
@@ -569,7 +551,7 @@ std::optional<std::pair<int, int>> SequencerPanel::getLiveBoundsOfGreaterCell(co
         if (!rightBound.has_value())
             return std::nullopt;
 
-        leftBound = getLeftBoundOfGreaterCellContainingCell(getLeftCell(getCellPtr(row, rightBound.value())));
+        leftBound = getLeftBoundOfGreaterCellContainingCell(row, getLeftColumn(rightBound.value()));
         if (!leftBound.has_value())
             return std::nullopt;
     }
@@ -579,17 +561,17 @@ std::optional<std::pair<int, int>> SequencerPanel::getLiveBoundsOfGreaterCell(co
         if (!leftBound.has_value())
             return std::nullopt;
 
-        rightBound = getRightBoundOfGreaterCellContainingCell(getCellPtr(row, leftBound.value()));
+        rightBound = getRightBoundOfGreaterCellContainingCell(row, leftBound.value());
         if (!rightBound.has_value())
             return std::nullopt;
     }
     else
     {
-        rightBound = getRightBoundOfGreaterCellContainingCell(getCellPtr(row, column));
+        rightBound = getRightBoundOfGreaterCellContainingCell(row, column);
         if (!rightBound.has_value())
             return std::nullopt;
 
-        leftBound = getLeftBoundOfGreaterCellContainingCell(getCellPtr(row, column));
+        leftBound = getLeftBoundOfGreaterCellContainingCell(row, column);
         if (!leftBound.has_value())
             return std::nullopt;
     }
@@ -597,54 +579,122 @@ std::optional<std::pair<int, int>> SequencerPanel::getLiveBoundsOfGreaterCell(co
     return std::make_optional<std::pair<int, int>>(leftBound.value(), rightBound.value());
 }
 
-void SequencerPanel::handleDraggingLeftCellEdge(SequencerCell* const cell, const juce::Point<int>& dragPosition,
-    const int& row, const std::pair<int, int>& currentBounds, const int& newLeftBound)
+void SequencerPanel::handleDraggingLeftCellEdge(const int& row, const int& column, const juce::Point<int>& dragPosition,
+    const std::pair<int, int>& currentBounds, const int& newLeftBound)
 {
     if (currentBounds.second == newLeftBound)
     {
-        handleDragEdgeOfNonGreaterCell(cell, dragPosition);
+        handleDragEdgeOfNonGreaterCell(row, column, dragPosition);
         repaintRow(row);
     }
     else// if (oldLeftBounds != newLeftBound)
     {
-        setDraggedGreaterCellLeftBound(row, currentBounds, newLeftBound);
-
-        auto& oldLeftBound{ currentBounds.first };
-        auto& rightBound{ currentBounds.second };
-
-        repaintRegion(getLeftColumn(rightwardDistance(oldLeftBound, rightBound) > rightwardDistance(newLeftBound, rightBound)
-                                    ? oldLeftBound : newLeftBound),
-                      rightBound,
-                      row, row - 1);
+        if (const auto changedColumns{ setDraggedGreaterCellLeftBound(row, currentBounds, newLeftBound) })
+            repaintRegion(changedColumns->first, getRightColumn(changedColumns->second), row, row - 1);
     }
 }
 
-void SequencerPanel::handleDraggingRightCellEdge(SequencerCell* const cell, const juce::Point<int>& dragPosition,
-    const int& row, const std::pair<int, int>& currentBounds, const int& newRightBound)
+void SequencerPanel::handleDraggingRightCellEdge(const int& row, const int& column, const juce::Point<int>& dragPosition,
+    const std::pair<int, int>& currentBounds, const int& newRightBound)
 {
     if (currentBounds.first == newRightBound)
     {
-        handleDragEdgeOfNonGreaterCell(cell, dragPosition);
+        handleDragEdgeOfNonGreaterCell(row, column, dragPosition);
         repaintRow(row);
     }
     else// if (oldRightBound != newRightBound)
     {
-        setDraggedGreaterCellRightBound(row, currentBounds, newRightBound);
+        if (const auto changedColumns{ setDraggedGreaterCellRightBound(row, currentBounds, newRightBound) })
+            repaintRegion(changedColumns->first, getRightColumn(changedColumns->second), row, row - 1);
+    }
+}
+
+void SequencerPanel::repaintRow(const int& row)
+{
+    for (auto column{ 0 }; column != columnsSize(); ++column)
+        refreshCell(row, column);
+}
+
+void SequencerPanel::syncCell(const int& row, const int& column)
+{
+    getCellPtr(row, column)->setState(pattern.isOn(row, column) ? SequencerCell::State::on : SequencerCell::State::off)
+                           ->setIsLeftConnected(pattern.getIsLeftConnected(row, column))
+                           ->setIsRightConnected(pattern.getIsRightConnected(row, column));
+}
+
+void SequencerPanel::refreshCell(const int& row, const int& column)
+{
+    //rows without SequencerCells are synced when they are given some
+    if (renderingMode == componentRendering && rowHasCells(row))
+        syncCell(row, column);
+
+    //pattern may have changed even if the cell can't be seen
+    triggerAsyncUpdate();
 
-        auto& leftBound{ currentBounds.first };
-        auto& oldRightBound{ currentBounds.second };
+    if (!rowIsVisible(row))
+        return;
+
+    //repainting the panel over a SequencerCell repaints the cell too, so both modes share dirtyRegion
+    if (renderingMode == componentRendering)
+        markDirty(getCellPtr(row, column)->getBoundsInParent());
+    else if (offsetsAreUpToDate())
+        markDirty(getCellBounds(row, column));
+}
+
+void SequencerPanel::markDirty(const juce::Rectangle<int>& bounds)
+{
+    dirtyRegion = dirtyRegion.getUnion(bounds);
+    triggerAsyncUpdate();
+}
 
-        repaintRegion(leftBound,
-                      getRightColumn(rightwardDistance(leftBound, oldRightBound) > rightwardDistance(leftBound, newRightBound)
-                                     ? oldRightBound : newRightBound),
-                      row, row - 1);
+void SequencerPanel::handleAsyncUpdate()
+{
+    if (!dirtyRegion.isEmpty())
+        repaint(dirtyRegion);
+
+    dirtyRegion = {};
+
+    if (pattern.getVersion() != notifiedPatternVersion)
+    {
+        notifiedPatternVersion = pattern.getVersion();
+
+        if (onPatternChanged)
+            onPatternChanged(pattern);
     }
 }
 
-void SequencerPanel::repaintRow(const int& row)
+void SequencerPanel::refreshAllCells()
 {
-    for (auto& iteratorCell : pattern[row])
-        iteratorCell->repaint();
+    if (renderingMode == componentRendering)
+        for (auto row{ firstCellRow }; row <= lastCellRow; ++row)
+            for (auto column{ 0 }; column != columnsSize(); ++column)
+                syncCell(row, column);
+
+    //the whole panel is repainted, so any pending dirtyRegion is covered, but handleAsyncUpdate() still has to notify onPatternChanged
+    dirtyRegion = {};
+    triggerAsyncUpdate();
+    repaint();
+}
+
+void SequencerPanel::createCells()
+{
+    //moving the window of rows with SequencerCells from nowhere creates and syncs all of them
+    moveCellRowsToVisibleRows();
+    handleFillingGridItems(numberOfVisibleRows);
+}
+
+void SequencerPanel::destroyCells()
+{
+    grid.items.clear();
+
+    for (auto& row : cells)
+    {
+        std::for_each(row.begin(), row.end(), [this](auto& cell) { handleRemovalOfCell(cell); });
+        row.clear();
+    }
+
+    firstCellRow = 0;
+    lastCellRow = -1;
 }
 
 void SequencerPanel::repaintRegion(const int& leftBound, const int& rightBound, const int& topBound, const int& bottomBound)
@@ -660,7 +710,7 @@ void SequencerPanel::repaintRegion(const int& leftBound, const int& rightBound,
 
         while (column != rightBound || notYetRepaintedColumnX)
         {
-            pattern[row][column]->repaint();
+            refreshCell(row, column);
 
             column = getRightColumn(column);
             notYetRepaintedColumnX = false;
@@ -670,89 +720,128 @@ void SequencerPanel::repaintRegion(const int& leftBound, const int& rightBound,
 
 bool SequencerPanel::rowIsInValidState(const int& row) const
 {
-    auto& patternRow{ pattern[row] };
+    return pattern.rowIsInValidState(row);
+}
 
-    for (const auto& cell : patternRow)
-        if (cell->isOn())
-        {
-            if (cell->getIsLeftConnected() && !getLeftCell(cell.get())->getIsRightConnected())
-            {
-                DBG(cell->getName() + " is left-connected but shouldn't be.");
-                return false;
-            }
-            if (cell->getIsRightConnected() && !getRightCell(cell.get())->getIsLeftConnected())
-            {
-                DBG(cell->getName() + " is right-connected but shouldn't be.");
-                return false;
-            }
+SequencerPanel::~SequencerPanel()
+{
+    cancelPendingUpdate();
+    destroyCells();
+}
 
-        }
-        else
-        {
-            if (cell->getIsLeftConnected())
-            {
-                DBG(cell->getName() + " is off but left-connected.");
-                return false;
-            }
-            if (cell->getIsRightConnected())
-            {
-                DBG(cell->getName() + " is off but right-connected.");
-                return false;
-            }
-        }
+void SequencerPanel::resized()
+{
+    layOutColumns();
+    updateRowOffsets();
+    layOutCells();
+}
+
+void SequencerPanel::layOutColumns()
+{
+    //where the morph puts each column depends on the number of base columns, so it is found again with the layout
+    morphedStartPositions.clearQuick();
+    if (isShowingMorph())
+    {
+        morphedStartPositions = morph->getStartPositions(morphTilt, baseColumnsSize());
+        shownMorphVersion = morph->getVersion();
+    }
 
-    return true;
+    std::vector<int> columnStartPositions(static_cast<size_t>(columnsSize()));
+    for (auto column{ 0 }; column != columnsSize(); ++column)
+        columnStartPositions[column] = getDrawnStartPosition(column);
+
+    columnLayout.layOut(std::move(columnStartPositions), pattern.getLength(), getWidth());
 }
 
-SequencerPanel::~SequencerPanel()
+PatternModel::Tick SequencerPanel::getDrawnStartPosition(const int& column) const
 {
-    for (auto& row : pattern)
-        std::for_each(row.begin(), row.end(),
-            [this](auto& cell)
-            {
-                cell->removeMouseListener(this);
-                removeChildComponent(cell.get());
-            });
+    if (morphedStartPositions.isEmpty())
+        return pattern.columnStartPosition(column);
+
+    //every repeat is morphed the same way, as PatternCompiler morphs them
+    const auto cashedBaseColumnsSize{ morphedStartPositions.size() };
+    return morphedStartPositions.getUnchecked(column % cashedBaseColumnsSize) + column / cashedBaseColumnsSize * CONSTANTS::TICKS_PER_REPEAT;
 }
 
-void SequencerPanel::resized()
+void SequencerPanel::showMorph(const TiltMorph* newMorph, const float& newTilt)
+{
+    const auto wasShowingMorph{ isShowingMorph() };
+    const auto morphChanged{ newMorph != morph || (newMorph != nullptr && newMorph->getVersion() != shownMorphVersion) };
+    const auto tiltChanged{ newTilt != morphTilt };
+
+    morph = newMorph;
+    morphTilt = newTilt;
+
+    if (morph != nullptr)
+        shownMorphVersion = morph->getVersion();
+
+    //e.g. every time the editor's timer calls this while tilt isn't moving
+    if ((!morphChanged && !tiltChanged) || (!wasShowingMorph && !isShowingMorph()))
+        return;
+
+    //pattern isn't edited, so this is only a new layout and a repaint, nothing is published or reported to onPatternChanged
+    layOutColumns();
+    layOutCells();
+}
+
+void SequencerPanel::layOutCells()
 {
-    grid.performLayout(getLocalBounds());
+    if (renderingMode == virtualisedRendering || !offsetsAreUpToDate())
+    {
+        repaint();
+        return;
+    }
+
+    //grid.items only holds the visible cells, so only they are given bounds
+    for (auto row{ referenceRow }; row <= getVisibleRowsMax(); ++row)
+        for (auto column{ 0 }; column != columnsSize(); ++column)
+            getCellPtr(row, column)->setBounds(getCellBounds(row, column));
 }
 
-std::vector<std::shared_ptr<SequencerCell>> SequencerPanel::cellsAsVector() const
+std::vector<SequencerCell*> SequencerPanel::cellsAsVector() const
 {
-    std::vector<std::shared_ptr<SequencerCell>> cellsAsVector;
+    std::vector<SequencerCell*> cellsAsVector;
     cellsAsVector.reserve(rowsSize() * columnsSize());
 
-    for (auto& row : pattern)
+    for (auto& row : cells)
         std::for_each(row.begin(), row.end(), [&cellsAsVector](auto& cell)
             { cellsAsVector.push_back(cell); });
 
     return cellsAsVector;
 }
 
-SequencerCell* SequencerPanel::getCellAtLocation(const juce::Point<int>& location)
+std::optional<std::pair<int, int>> SequencerPanel::getCellCoordinatesAtLocation(const juce::Point<int>& location) const
 {
-    for (const auto& item : grid.items)
-    {
-        auto component{ item.associatedComponent };
-        if (component && component->getBoundsInParent().contains(location))
-            return static_cast<SequencerCell*>(component);
+    if (!offsetsAreUpToDate())
+        return std::nullopt;
 
-    }
+    const auto column{ columnLayout.findColumn(location.getX()) };
+    const auto visibleRow{ ColumnLayout::findSpan(rowOffsets, location.getY()) };
 
-    return nullptr;
+    if (!column.has_value() || !visibleRow.has_value())
+        return std::nullopt;
+
+    //visible rows are counted from the top, whereas rows in pattern are counted from the bottom
+    return std::make_pair(getVisibleRowsMax() - visibleRow.value(), column.value());
 }
 
-std::optional<int> SequencerPanel::findGridItemIndex(const std::shared_ptr<SequencerCell>& cell) const
+void SequencerPanel::showRecordedNote(const int& row, const int& column)
 {
-    auto& items = grid.items;
-    for (int i = 0; i < items.size(); ++i)
-        if (items.getUnchecked(i).associatedComponent == cell.get())
-            return i;
+    jassert(row >= 0 && row < rowsSize() && column >= 0 && column < columnsSize());
 
-    return -1;//could make this an optional, can't be bothered
+    //the recorded note is a cell of its own, so none of its neighbours changed
+    refreshCell(row, column);
+}
+
+std::optional<int> SequencerPanel::getRowAtY(const int& y) const
+{
+    if (!offsetsAreUpToDate())
+        return std::nullopt;
+
+    if (const auto visibleRow{ ColumnLayout::findSpan(rowOffsets, y) })
+        return getVisibleRowsMax() - visibleRow.value();
+
+    return std::nullopt;
 }
 
 void SequencerPanel::shiftVisibleRows(int shiftFactor)
@@ -766,372 +855,282 @@ void SequencerPanel::shiftVisibleRows(int shiftFactor)
     else if (shiftFactor + getVisibleRowsMax() >= CONSTANTS::MIDI_PITCHES_SIZE)
         shiftFactor = CONSTANTS::MIDI_PITCHES_SIZE - getVisibleRowsMax() - 1;
 
-    for (auto itemIndex{ 0 }; itemIndex != grid.items.size(); ++itemIndex)
-        shiftGridItem(itemIndex, shiftFactor);
+    //the SequencerCells of the rows which stay visible are hidden too, then shown again when grid.items is refilled
+    if (renderingMode == componentRendering)
+        for (auto& item : grid.items)
+            item.associatedComponent->setVisible(false);
 
     referenceRow += shiftFactor;
 
-    resized();
+    if (renderingMode == componentRendering)
+    {
+        moveCellRowsToVisibleRows();
+        handleFillingGridItems(numberOfVisibleRows);
+    }
+
+    layOutCells();
 }
 
-void SequencerPanel::shiftGridItem(const int& itemIndex, const int& shiftFactor)
+void SequencerPanel::setVisibleWindow(const int& newReferenceRow, const int& newVisibleRows)
 {
-    const auto [row, column] { gridItemsCoordinates(itemIndex) };
+    jassert(newReferenceRow >= 0 && newVisibleRows > 0 && newReferenceRow + newVisibleRows <= rowsSize());
 
-    if (row >= referenceRow + numberOfVisibleRows + shiftFactor || row <= referenceRow + shiftFactor)
-        grid.items.getUnchecked(itemIndex).associatedComponent->setVisible(false);
+    //the window is only ever shifted or resized while every row of it exists, so shrink it before it is shifted and grow it after
+    if (newVisibleRows < numberOfVisibleRows)
+        setNumberOfVisibleRows(newVisibleRows);
 
-    grid.items.setUnchecked(itemIndex, pattern[row + shiftFactor][column].get());
-    grid.items.getUnchecked(itemIndex).associatedComponent->setVisible(true);
+    shiftVisibleRows(newReferenceRow - referenceRow);
+    setNumberOfVisibleRows(newVisibleRows);
 }
 
 void SequencerPanel::shuffleRow(const int& row, const int& offset)
 {
-    if (row < 0 || row >= rowsSize() || offset == 0 || row + offset < 0 || row + offset >= rowsSize())
-    {
-        jassertfalse;
+    pattern.shuffleRow(row, offset);
+
+    //the SequencerCells stay where they are and show the rows which moved under them
+    for (auto shuffledRow{ std::min(row, row + offset) }; shuffledRow <= std::max(row, row + offset); ++shuffledRow)
+        if (shuffledRow >= 0 && shuffledRow < rowsSize())
+            repaintRow(shuffledRow);
+}
+
+void SequencerPanel::beginStructuralEdit()
+{
+    //the SequencerCell the mouse is over may end up viewing another cell
+    if (structuralEditDepth++ == 0)
+        exitLastCellOver();
+}
+
+void SequencerPanel::commitStructuralEdit()
+{
+    jassert(structuralEditDepth > 0);
+
+    if (structuralEditDepth == 0 || --structuralEditDepth > 0)
         return;
-    }
 
-    int newRow = row + offset;
+    if (renderingMode == componentRendering)
+        resizeRowsOfCells();
+
+    if (columnsNeedLayingOut || columnLayout.size() != columnsSize())
+        layOutColumns();
 
-    if (newRow > row) // Shift left
-        std::move(pattern.begin() + row + 1, pattern.begin() + newRow + 1, pattern.begin() + row);
-    else // Shift right
-        std::move_backward(pattern.begin() + newRow, pattern.begin() + row, pattern.begin() + row + 1);
+    columnsNeedLayingOut = false;
 
-    pattern[newRow] = std::move(pattern[row]);
+    refreshAllCells();
+    layOutCells();
 }
 
-void SequencerPanel::setRepeats(const int& newRepeats)
+void SequencerPanel::syncWithPattern()
 {
-    if (newRepeats < 1)
-        return;
+    beginStructuralEdit();
 
-    if (newRepeats > repeats)
-        handleNewRepeatsIsGreaterThanOld(newRepeats);
-    else if (newRepeats < repeats)
-        removeLastColumns((repeats - newRepeats) * baseColumnsSize());
-    else
-        return;
+    //cells which were selected or dragged may not exist any more
+    resetDraggingStates();
+    selectedCells.clear();
 
-    repeats = newRepeats;
+    columnsNeedLayingOut = true;
+    notifiedPatternVersion = pattern.getVersion();
 
-    updateTemplateColumns();
-    resized();
+    commitStructuralEdit();
 }
 
-void SequencerPanel::handleNewRepeatsIsGreaterThanOld(const int& newRepeats)
+void SequencerPanel::setRepeats(const int& newRepeats)
 {
-    const auto cashedBaseColumnsSize{ baseColumnsSize() };
+    const auto clampedRepeats{ juce::jlimit(1, CONSTANTS::MAX_REPEATS, newRepeats) };
+    if (clampedRepeats == getRepeats())
+        return;
 
-    //allocating requisite storage for each row and setting edge connections
-    for (auto& row : pattern)
-    {
-        row.reserve(newRepeats * cashedBaseColumnsSize);
+    beginStructuralEdit();
 
-        row[0]->setIsLeftConnected(false);
-        row[row.size() - 1]->setIsRightConnected(false);
-    }
+    pattern.setRepeats(clampedRepeats);
+
+    //every column's edge is relative to the number of repeats, so they all move
+    columnsNeedLayingOut = true;
 
-    for (auto repeat{ repeats }; repeat != newRepeats; ++repeat)
-        for (auto column{ 0 }; column != startPositions.size(); ++column)
-            addCell();
+    commitStructuralEdit();
 }
 
-void SequencerPanel::insertColumn(float startPosition)
+void SequencerPanel::insertColumn(const PatternModel::Tick& startPosition)
 {
-    jassert(startPosition > 0 && startPosition < repeats);
+    jassert(startPosition > 0 && startPosition < pattern.getLength());
 
-    //since an inserted startPosition will be inserted across all repeats, we use 
-    //a start position on the first repeat so the function's logic is uniform
-    startPosition -= (int)startPosition;
+    //a column already starts there
+    if (!pattern.findIndex(startPosition).has_value())
+        return;
 
-    const auto index{ findIndex(startPosition) };
-    const auto newBaseSize{ baseColumnsSize() + 1 };
+    beginStructuralEdit();
 
-    for (auto& row : pattern)
-        row.reserve(newBaseSize * repeats);
+    const auto index{ pattern.insertColumn(startPosition) };
+    const auto newBaseSize{ baseColumnsSize() };
 
-    //adding 1 to each step of the loop to account for the inserted Cell
-    for (auto repeatedIndex{ index % newBaseSize };
-        repeatedIndex != index % newBaseSize + repeats * newBaseSize;
-        repeatedIndex += newBaseSize)
-    {
-        insertCell(repeatedIndex);
-    }
+    //the morph spreads the base columns out between its grids by how many there are, so they all move
+    if (isShowingMorph())
+        columnsNeedLayingOut = true;
 
-    startPositions.insert(index, startPosition);
+    //the other columns' edges don't move, they only move along an index
+    if (!columnsNeedLayingOut)
+        for (auto repeatedIndex{ index }; repeatedIndex < columnsSize(); repeatedIndex += newBaseSize)
+            columnLayout.insertColumn(repeatedIndex, getDrawnStartPosition(repeatedIndex));
 
-    updateTemplateColumns();
-    resized();
+    commitStructuralEdit();
 }
 
 void SequencerPanel::removeColumn(const int& index)
 {
     jassert(index > 0 && index < columnsSize() /*&& index % getBaseColumnsSize() != 0*/);
 
-    const auto baseSize{ baseColumnsSize() };
-    const auto newBaseSize{ baseSize - 1 };
-    const auto baseIndex{ index % baseSize };
+    beginStructuralEdit();
 
-    //subtracting 1 from each step of the loop to account for the removed Cell
-    for (auto repeatedIndex{ baseIndex };
-        repeatedIndex != baseIndex + repeats * newBaseSize;
-        repeatedIndex += newBaseSize)
-        removeCell(repeatedIndex);
+    const auto newBaseSize{ baseColumnsSize() - 1 };
+    const auto baseIndex{ index % baseColumnsSize() };
 
-    startPositions.remove(baseIndex);
+    pattern.removeColumn(baseIndex);
 
-    updateTemplateColumns();
-    resized();
-}
+    //the morph spreads the base columns out between its grids by how many there are, so they all move
+    if (isShowingMorph())
+        columnsNeedLayingOut = true;
 
-bool SequencerPanel::startPositionsIsValid(const juce::Array<float>& posiblyInvalidStartPositions) const
-{
-    if (posiblyInvalidStartPositions.isEmpty())
-        return true;
+    //the other columns' edges don't move, they only move along an index
+    //subtracting 1 from each step of the loop to account for the removed column
+    if (!columnsNeedLayingOut)
+        for (auto repeatedIndex{ baseIndex };
+            repeatedIndex != baseIndex + getRepeats() * newBaseSize;
+            repeatedIndex += newBaseSize)
+            columnLayout.removeColumn(repeatedIndex);
 
-    if (std::find_if(posiblyInvalidStartPositions.begin(), posiblyInvalidStartPositions.end(),
-            [](const float& position)
-            {
-                return position < 0.f || position > 1.f; //ensure positions are in range [0, 1]
-            }) 
-            == posiblyInvalidStartPositions.end() ||
-        std::adjacent_find(posiblyInvalidStartPositions.begin(), posiblyInvalidStartPositions.end(),
-            [](const float& positionA, const float& positionB)
-            {
-                return positionA >= positionB; //ensure positions are in ascending order
-            })
-            == posiblyInvalidStartPositions.end()
-        )
-        return true;
-    
-    return false;
+    commitStructuralEdit();
 }
 
-void SequencerPanel::shiftStartPositions(juce::Array<float> newStartPositions)
+void SequencerPanel::shiftStartPositions(juce::Array<PatternModel::Tick> newStartPositions)
 {
-    jassert(newStartPositions.size() == baseColumnsSize() - 1);
-
-    jassert(startPositionsIsValid(newStartPositions));
+    //start positions the morph would override are never saved, let alone drawn or played
+    if (isShowingMorph())
+        return;
 
-    newStartPositions.insert(0, 0.f);
-    startPositions = newStartPositions;
+    //nothing would move
+    if (newStartPositions.size() == baseColumnsSize() - 1
+        && std::equal(newStartPositions.begin(), newStartPositions.end(), pattern.getStartPositions().begin() + 1))
+        return;
 
-    updateTemplateColumns();
-    resized();
-}
+    beginStructuralEdit();
 
-float SequencerPanel::columnStartPosition(const int& column) const
-{
-    const auto cashedBaseColumnsSize{ baseColumnsSize() };
-    jassert(column >= 0 && column <= cashedBaseColumnsSize * repeats);
+    const auto oldStartPositions{ pattern.getStartPositions() };
 
-    return startPositions.getUnchecked(column % cashedBaseColumnsSize) + column / cashedBaseColumnsSize;
-}
+    pattern.shiftStartPositions(newStartPositions);
 
-float SequencerPanel::columnWidth(const int& column) const
-{
-    return columnStartPosition(column + 1) - columnStartPosition(column);
-}
+    //only the edges of columns whose start position changed move
+    if (!columnsNeedLayingOut)
+        for (auto baseColumn{ 1 }; baseColumn < baseColumnsSize(); ++baseColumn)
+            if (pattern.getStartPositions().getUnchecked(baseColumn) != oldStartPositions.getUnchecked(baseColumn))
+                for (auto column{ baseColumn }; column < columnsSize(); column += baseColumnsSize())
+                    columnLayout.moveColumn(column, getDrawnStartPosition(column));
 
-int SequencerPanel::columnWidthAsGridFr(const int& column) const
-{
-    return static_cast<int>(std::round((columnWidth(column) / repeats) * getLocalBounds().getWidth()));
+    commitStructuralEdit();
 }
 
-void SequencerPanel::handleAdditionOfCellToPattern(const int& row, const std::shared_ptr<SequencerCell>& cell)
+void SequencerPanel::handleAdditionOfCellToCells(const int& row, SequencerCell* cell)
 {
     if (!cell)
         return;
 
-    pattern[row].push_back(cell);
+    cells[row].push_back(cell);
 
-    addChildComponent(cell.get());
-    cell.get()->addMouseListener(this, true);
+    addChildComponent(cell);
+    cell->addMouseListener(this, true);
 }
 
-void SequencerPanel::addCell()
+void SequencerPanel::handleRemovalOfCell(SequencerCell* cell)
 {
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-        handleAdditionOfCellToPattern(row, std::shared_ptr<SequencerCell>(new SequencerCell));
-
-    //adds this Cell pointer into grid.items, we have to add these backwards because Grid logic
-    for (auto visibleRow{ numberOfVisibleRows - 1 }; visibleRow >= 0; --visibleRow)
-    {
-        auto& row{ pattern[visibleRow + referenceRow] };
-        auto addedCell{ row[row.size() - 1].get()};
-
-        grid.items.add(addedCell);
-        addedCell->setVisible(true);
-    }
+    cell->removeMouseListener(this);
+    removeChildComponent(cell);
+    cellPool.release(cell);
 }
 
-void SequencerPanel::insertCell(const int& column)
+void SequencerPanel::resizeRowsOfCells()
 {
-    jassert(column > 0 && column <= columnsSize());
+    for (auto row{ firstCellRow }; row <= lastCellRow; ++row)
+        resizeRowOfCells(row);
 
-    const auto preInsertionColumnsSize{ columnsSize() };
+    handleFillingGridItems(numberOfVisibleRows);
+}
 
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-        handleInsertionOfCellToPattern(row, column, preInsertionColumnsSize);
+void SequencerPanel::resizeRowOfCells(const int& row)
+{
+    const auto newColumnsSize{ static_cast<size_t>(columnsSize()) };
+    auto& cellsRow{ cells[row] };
 
-    //inserts this Cell pointer into grid.items
-    const auto index{ gridItemsIndex(numberOfVisibleRows - 1, column - 1) + 1 };
-    for (auto visibleRow{ 0 }; visibleRow != numberOfVisibleRows; ++visibleRow)
+    if (cellsRow.size() > newColumnsSize)
     {
-        auto insertedCell{ getCellInPattern(visibleRow + referenceRow, column).get()};
+        std::for_each(cellsRow.begin() + newColumnsSize, cellsRow.end(), [this](auto& cell) { handleRemovalOfCell(cell); });
+        cellsRow.resize(newColumnsSize);
+    }
+    else
+    {
+        cellsRow.reserve(newColumnsSize);
 
-        grid.items.insert(index, insertedCell);
-        insertedCell->setVisible(true);
+        while (cellsRow.size() < newColumnsSize)
+            handleAdditionOfCellToCells(row, cellPool.acquire());
     }
 }
 
-void SequencerPanel::handleInsertionOfCellToPattern(const int& row, const int& column, const int& preInsertionColumnsSize)
+void SequencerPanel::moveCellRowsToVisibleRows()
 {
-    auto& patternRow{ pattern[row] };
+    jassert(renderingMode == componentRendering);
 
-    //inserts a new Cell pointer at index in each row
-    patternRow.insert(patternRow.begin() + column, std::shared_ptr<SequencerCell>(new SequencerCell));
+    const auto newFirstCellRow{ std::max(0, referenceRow - cellRowsMargin) };
+    const auto newLastCellRow{ std::min(rowsSize() - 1, getVisibleRowsMax() + cellRowsMargin) };
 
-    auto insertedCell{ patternRow[column].get()};
+    //the rows leaving the window give up their SequencerCells
+    std::vector<std::vector<SequencerCell*>> spareRows;
+    for (auto row{ firstCellRow }; row <= lastCellRow; ++row)
+        if (row < newFirstCellRow || row > newLastCellRow)
+            spareRows.push_back(std::move(cells[row]));
 
-    handleCellConnectionsDuringInsertion(row, column, preInsertionColumnsSize);
+    //and the rows coming into it take them
+    for (auto row{ newFirstCellRow }; row <= newLastCellRow; ++row)
+    {
+        if (rowHasCells(row))
+            continue;
 
-    addChildComponent(insertedCell);
-    insertedCell->addMouseListener(this, true);
-}
+        auto& cellsRow{ cells[row] };
+        cellsRow.clear();
 
-void SequencerPanel::handleCellConnectionsDuringInsertion(const int& row, const int& column, const int& preInsertionColumnsSize)
-{
-    auto insertedCell{ getCellInPattern(row, column) };
-    auto leftCell{ getCellInPattern(row, CUSTOM_FUNCTIONS::positiveMod(column - 1, preInsertionColumnsSize)) };
-
-    if (leftCell && leftCell->getState() == SequencerCell::State::on)
-    {
-        insertedCell->setState(SequencerCell::State::on)->setIsLeftConnected(SequencerCell::State::on);
+        if (!spareRows.empty())
+        {
+            cellsRow = std::move(spareRows.back());
+            spareRows.pop_back();
+        }
 
-        if (leftCell->getIsRightConnected())
-            insertedCell->setIsRightConnected(true);
+        resizeRowOfCells(row);
 
-        leftCell->setIsRightConnected(true);
+        for (auto column{ 0 }; column != columnsSize(); ++column)
+        {
+            getCellPtr(row, column)->setVisible(false);
+            getCellPtr(row, column)->setMouseIsOverCell(false);
+            syncCell(row, column);
+        }
     }
+
+    //only if the window shrank
+    for (auto& spareRow : spareRows)
+        std::for_each(spareRow.begin(), spareRow.end(), [this](auto& cell) { handleRemovalOfCell(cell); });
+
+    firstCellRow = newFirstCellRow;
+    lastCellRow = newLastCellRow;
 }
 
-const juce::GridItem* SequencerPanel::findGridItemPointer(const std::shared_ptr<SequencerCell>& cell) const
+const juce::GridItem* SequencerPanel::findGridItemPointer(const SequencerCell* cell) const
 {
     auto& items{ grid.items };
     auto iterator{ std::find_if(items.begin(), items.end(),
                                 [&cell](auto& gridItem)
                                 {
-                                    return cell.get() == gridItem.associatedComponent;
+                                    return cell == gridItem.associatedComponent;
                                 }) };
     //chatGPT said use &(*iterator) but I don't understand why so ignored it ;P
     return iterator != items.end() ? iterator
         : nullptr;
 }
 
-void SequencerPanel::removeLastColumns(const int& numberOfCellsToRemove = 1)
-{
-    jassert(numberOfCellsToRemove > 0 && numberOfCellsToRemove <= columnsSize());
-
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-    {
-        auto& patternRow{ pattern[row] };
-
-        if (row >= referenceRow && row <= getVisibleRowsMax())
-            std::for_each(patternRow.end() - numberOfCellsToRemove, patternRow.end(),
-                [this, &patternRow](auto& cell)
-                {
-                    cell->setVisible(false);
-                    cell->removeMouseListener(this);
-
-                    const auto index{ findGridItemIndex(cell) };
-                    if (index.has_value())
-                        grid.items.remove(index.value()); // remove by index, safe
-                });
-
-        patternRow.resize(patternRow.size() - numberOfCellsToRemove);
-
-        //handling cell connections
-        if (patternRow[0]->getIsLeftConnected())
-            patternRow[0]->setIsLeftConnected(false);
-
-        if (patternRow[patternRow.size() - 1]->getIsRightConnected())
-        {
-            patternRow[patternRow.size() - 1]->setIsRightConnected(false);
-            patternRow[0]->setIsLeftConnected(false);
-        }
-    }
-}
-
-void SequencerPanel::handleRemovalOfCellFromCells(const int& row, const int& column, const int& preRemovalColumnsSize)
-{
-    auto& patternRow{ pattern[row] };
-
-    //handleCellConnectionsDuringRemoval(row, column, preInsertionColumnsSize);
-    auto removedCell{ patternRow[column] };
-
-    //this function should not be moved from it's relative position inside this function
-    handleCellConnectionsDuringRemoval(row, column, preRemovalColumnsSize);
-
-    const auto index{ findGridItemIndex(removedCell) };
-    if (index.has_value())
-        grid.items.remove(index.value());
-
-    removedCell->removeMouseListener(this);
-    //patternRow.erase(find(patternRow.begin(), patternRow.end(), ))
-    patternRow.erase(patternRow.begin() + column);
-}
-
-void SequencerPanel::handleCellConnectionsDuringRemoval(const int& row, const int& column, const int& preRemovalColumnsSize)
-{
-    auto leftCell{ getCellInPattern(row, CUSTOM_FUNCTIONS::positiveMod(column - 1, preRemovalColumnsSize)) };
-    auto rightCell{ getCellInPattern(row, CUSTOM_FUNCTIONS::positiveMod(column + 1, preRemovalColumnsSize)) };
-
-    if (leftCell->getIsRightConnected())
-        if (!rightCell->getIsLeftConnected())
-            leftCell->setIsRightConnected(false);
-        else if (rightCell->getIsLeftConnected())
-            rightCell->setIsLeftConnected(false);
-
-    leftCell->repaint();
-    rightCell->repaint();
-}
-
-void SequencerPanel::removeCell(const int& column)
-{
-    jassert(column > 0 && column <= columnsSize());
-
-    //const auto cashedRowsSize{ rowsSize() };
-    const auto cashedColumnsSize{ columnsSize() };
-
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-        handleRemovalOfCellFromCells(row, column, cashedColumnsSize);
-}
-
-int SequencerPanel::findIndex(const float& startPosition)
-{
-    const auto baseSize{ baseColumnsSize() };
-
-    for (auto index{ 1 }; index <= baseSize * repeats; ++index)
-        if (startPosition > startPositions.getUnchecked((index - 1) % baseSize) + (index - 1) / baseSize &&
-            startPosition < startPositions.getUnchecked(index % baseSize) + index / baseSize)
-            return index;
-
-    jassertfalse; //you never should have come here!
-    return {};
-}
-
-int SequencerPanel::gridItemsIndex(const int& row, const int& column) const
-{
-    jassert(row >= 0 && row < numberOfVisibleRows &&
-        column >= 0 && column < columnsSize());
-
-    return row + column * numberOfVisibleRows;
-}
-
 std::pair<int, int> SequencerPanel::gridItemsCoordinates(const int& gridItemsIndex) const
 {
     jassert(gridItemsIndex >= 0 && gridItemsIndex < grid.items.size());
@@ -1140,129 +1139,79 @@ std::pair<int, int> SequencerPanel::gridItemsCoordinates(const int& gridItemsInd
              gridItemsIndex / numberOfVisibleRows };                       //column
 }
 
-std::optional<std::pair<int, int>> SequencerPanel::getCellCoordinates(const SequencerCell* const cell) const
-{
-    jassert(cell != nullptr);
-
-    if (cell == nullptr)//the cell does not exist
-        return std::nullopt;
-
-    for (auto row{ 0 }; row != rowsSize(); ++row)
-        for (auto column{ 0 }; column != columnsSize(); ++column)
-            if (getCellPtr(row, column) == cell)
-                return std::make_pair(row, column);//the cell exists and is in the grid
-
-    return std::nullopt;; //the cell exists but is not in the grid??
-}
-
-std::optional<int> SequencerPanel::getCellRow(const SequencerCell* const cell) const
+void SequencerPanel::updateRowOffsets()
 {
-    if (const auto coords = getCellCoordinates(cell))
-        return coords->first;
+    rowOffsets.resize(numberOfVisibleRows + 1);
 
-    return std::nullopt;
+    //rows share the height equally, rounded to the nearest pixel like grid does
+    for (auto visibleRow{ 0 }; visibleRow <= numberOfVisibleRows; ++visibleRow)
+        rowOffsets[visibleRow] = juce::roundToInt(static_cast<double>(visibleRow) * getHeight() / numberOfVisibleRows);
 }
 
-std::optional<int> SequencerPanel::getCellColumn(const SequencerCell* const cell) const
+bool SequencerPanel::offsetsAreUpToDate() const
 {
-    if (const auto coords = getCellCoordinates(cell))
-        return coords->second;
-
-    return std::nullopt;
+    return columnLayout.size() == columnsSize()
+        && rowOffsets.size() == static_cast<size_t>(numberOfVisibleRows) + 1
+        && getHeight() > 0;
 }
 
-void SequencerPanel::updateTemplateColumns()
+void SequencerPanel::snapshotRow(const int& row)
 {
-    std::vector<int> newTemplateColumns;
-    makeIdealWidths(newTemplateColumns);
-    distributeError(newTemplateColumns);
+    jassert(rowSnapshot.empty());
 
-    grid.templateColumns.resize(columnsSize());
-
-    for (auto column{ 0 }; column != columnsSize(); ++column)
-        grid.templateColumns.setUnchecked(column, juce::Grid::Px(newTemplateColumns[column]));
+    pattern.copyRow(row, rowSnapshot);
+    rowSnapshotSpans = pattern.getNoteSpans(row);
 }
 
-void SequencerPanel::makeIdealWidths(std::vector<int>& newTemplateColumns) const
+void SequencerPanel::restoreCellFromRowSnapshot(const int& row, const int& column)
 {
-    newTemplateColumns.reserve(columnsSize());
-
-    for (auto column{ 0 }; column != columnsSize(); ++column)
-        newTemplateColumns.push_back(column < baseColumnsSize() ? columnWidthAsGridFr(column)
-            : newTemplateColumns[column % baseColumnsSize()]);
+    pattern.setCell(row, column, rowSnapshot[column]);
 }
 
-void SequencerPanel::distributeError(std::vector<int>& newTemplateColumns) const
+void SequencerPanel::exitLastCellOver()
 {
-    const auto error{ std::accumulate(newTemplateColumns.begin(), newTemplateColumns.end(), 0)
-                      + (columnsSize() - 1) * grid.columnGap.pixels
-                      - getLocalBounds().getWidth() };
-
-    if (error == 0)
+    if (!lastOverCell.has_value())
         return;
 
-    if (const auto interval{ columnsSize() / std::abs(error) })
-    {
-        int index{ 0 };
-        while (index < std::abs(error))
-            newTemplateColumns[index++ * interval] -= error / std::abs(error);
-    }
-}
+    const auto [row, column] { lastOverCell.value() };
+    lastOverCell.reset();
 
-void SequencerPanel::snapshotRow(const int& row)
-{
-    jassert(rowSnapshot.isEmpty());
+    //the cell may have been removed since the mouse was over it
+    if (column >= columnsSize())
+        return;
 
-    rowSnapshot.clear();
-    rowSnapshot.ensureStorageAllocated(rowsSize());
+    //the row may have scrolled far enough away since that its SequencerCells were recycled, and they forget the mouse when they are
+    if (renderingMode == componentRendering && rowHasCells(row))
+        getCellPtr(row, column)->setMouseIsOverCell(false);
 
-    for (const auto& rowCell : pattern[row])
-        rowSnapshot.add(std::make_unique<SequencerCell>(*rowCell));
-}
-
-void SequencerPanel::exitLastCellOver()
-{
-    if (lastOverCell && lastOverCell->getMouseIsOverCell())
-    {
-        lastOverCell->setMouseIsOverCell(false);
-        lastOverCell->repaint();
-    }
+    refreshCell(row, column);
 }
 
 std::optional<int> SequencerPanel::getLeftBoundOfGreaterCellAtColumnInRowSnapshot(const int& column) const
 {
-    if (!rowSnapshot.getReference(column)->getIsLeftConnected())
+    if (!(rowSnapshot[column] & PatternModel::onFlag))
         return column;
 
-    auto leftwardColumn{ getLeftColumn(column) };
-    while (leftwardColumn != column)
-        if (!rowSnapshot.getReference(leftwardColumn)->getIsLeftConnected())
-            return leftwardColumn;
-        else
-            leftwardColumn = getLeftColumn(leftwardColumn);
+    if (const auto noteSpan{ PatternModel::findNoteSpan(rowSnapshotSpans, column, columnsSize()) })
+        return noteSpan->start;
 
     return std::nullopt;
 }
 
 std::optional<int> SequencerPanel::getRightBoundOfGreaterCellAtColumnInRowSnapshot(const int& column) const
 {
-    auto rightwardColumn{ getRightColumn(column) };
+    if (!(rowSnapshot[column] & PatternModel::onFlag))
+        return getRightColumn(column);
 
-    if (!rowSnapshot.getReference(column)->getIsRightConnected())
-        return rightwardColumn;
-
-    while (rightwardColumn != column)
-        if (!rowSnapshot.getReference(rightwardColumn)->getIsRightConnected())
-            return getRightColumn(rightwardColumn);
-        else
-            rightwardColumn = getRightColumn(rightwardColumn);
+    if (const auto noteSpan{ PatternModel::findNoteSpan(rowSnapshotSpans, column, columnsSize()) })
+        return noteSpan->end(columnsSize());
 
     return std::nullopt;
 }
 
 std::optional<std::pair<int, int>> SequencerPanel::getBoundsOfGreaterCellAtColumnInRowSnapshot(const int& column) const
 {
-    if (rowSnapshot.isEmpty() || column >= rowSnapshot.size())
+    if (rowSnapshot.empty() || column >= static_cast<int>(rowSnapshot.size()))
         return std::nullopt;
 
     std::pair<int, int> bounds;
@@ -1288,94 +1237,88 @@ inline int SequencerPanel::leftwardDistance(const int& originColumn, const int&
     return CUSTOM_FUNCTIONS::positiveMod(originColumn - destinationColumn, columnsSize());
 }
 
-void SequencerPanel::setDraggedGreaterCellLeftBound(const int& row, const std::pair<int, int>& oldBounds, const int& newLeftBound)
+std::optional<std::pair<int, int>> SequencerPanel::setDraggedGreaterCellLeftBound(const int& row, const std::pair<int, int>& oldBounds, const int& newLeftBound)
 {
     const auto& [oldLeftBound, rightBound] = oldBounds;
 
     const auto snapshotBounds{ getBoundsOfGreaterCellAtColumnInRowSnapshot(getLeftColumn(rightBound)) };
     if (!snapshotBounds.has_value())
-        return;
-
-    auto& patternRow{ pattern[row] };
-
-    const auto greaterCellShrunk{ columnIsWithinBounds(newLeftBound, snapshotBounds.value()) };
-    const auto leftOfRightBound{ getLeftColumn(rightBound) };
-
-    for (auto column{ 0 }; column != columnsSize(); ++column)
-    {
-        auto cell{ patternRow[column] };
+        return std::nullopt;
 
-        //1: do this if cell is part of the dragged greater cell
-        if (columnIsWithinBounds(column, { newLeftBound, rightBound }))
-        {
-            cell->setState(SequencerCell::State::on)->setIsLeftConnected(true)->setIsRightConnected(true);
+    //a row is a function of rowSnapshot and the dragged bounds, so moving the left bound only changes the columns it
+    //moved across and the column left of them, unless the last drag event changed more than the dragged greater cell
+    const auto furtherLeftBound{ rightwardDistance(oldLeftBound, rightBound) > rightwardDistance(newLeftBound, rightBound)
+                                 ? oldLeftBound : newLeftBound };
+    const auto nearerLeftBound{ furtherLeftBound == oldLeftBound ? newLeftBound : oldLeftBound };
 
-            if (column == newLeftBound)
-                cell->setIsLeftConnected(false);
-            if (column == leftOfRightBound)
-                cell->setIsRightConnected(false);
+    const auto changedColumns{ lastDragChangedWholeRow ? std::make_pair(0, columnsSize() - 1)
+                                                       : std::make_pair(getLeftColumn(furtherLeftBound), nearerLeftBound) };
 
-            continue;
-        }
+    for (auto step{ 0 }; step != std::min(rightwardDistance(changedColumns.first, changedColumns.second) + 1, columnsSize()); ++step)
+        setCellAroundDraggedGreaterCell(row, getRightColumn(changedColumns.first, step), { newLeftBound, rightBound }, snapshotBounds.value());
 
-        //2: do this if cell was only part of the dragged greater cell when dragging began
-        const auto& snapshotLeftBound{ snapshotBounds.value().first };
-        if (greaterCellShrunk && columnIsWithinBounds(column, { snapshotLeftBound, getRightColumn(newLeftBound) }))
-        {
-            cell->turnOff();
-            continue;
-        }
-
-        //3: do this if neither conditions are met
-        cell->setCell(*rowSnapshot.getReference(column));
-        if (column == getLeftColumn(newLeftBound))
-            cell->setIsRightConnected(false);
-    }
+    lastDragChangedWholeRow = false;
+    return changedColumns;
 }
 
-void SequencerPanel::setDraggedGreaterCellRightBound(const int& row, const std::pair<int, int>& oldBounds, const int& newRightBound)
+std::optional<std::pair<int, int>> SequencerPanel::setDraggedGreaterCellRightBound(const int& row, const std::pair<int, int>& oldBounds, const int& newRightBound)
 {
     const auto& [leftBound, oldRightBound] = oldBounds;
 
     const auto snapshotBounds{ getBoundsOfGreaterCellAtColumnInRowSnapshot(leftBound) };
     if (!snapshotBounds.has_value())
-        return;
+        return std::nullopt;
 
-    auto& patternRow{ pattern[row] };
+    //a row is a function of rowSnapshot and the dragged bounds, so moving the right bound only changes the columns it
+    //moved across, the column it is now on and the column left of them, unless the last drag event changed more than
+    //the dragged greater cell
+    const auto furtherRightBound{ rightwardDistance(leftBound, oldRightBound) > rightwardDistance(leftBound, newRightBound)
+                                  ? oldRightBound : newRightBound };
+    const auto nearerRightBound{ furtherRightBound == oldRightBound ? newRightBound : oldRightBound };
 
-    const auto greaterCellShrunk{ columnIsWithinBounds(newRightBound, snapshotBounds.value()) };
-    const auto leftOfNewRightBound{ getLeftColumn(newRightBound) };
+    const auto changedColumns{ lastDragChangedWholeRow ? std::make_pair(0, columnsSize() - 1)
+                                                       : std::make_pair(getLeftColumn(nearerRightBound), furtherRightBound) };
 
-    for (auto column{ 0 }; column != columnsSize(); ++column)
-    {
-        auto cell{ patternRow[column] };
+    for (auto step{ 0 }; step != std::min(rightwardDistance(changedColumns.first, changedColumns.second) + 1, columnsSize()); ++step)
+        setCellAroundDraggedGreaterCell(row, getRightColumn(changedColumns.first, step), { leftBound, newRightBound }, snapshotBounds.value());
 
-        //1: do this if cell is part of the dragged greater cell
-        if (columnIsWithinBounds(column, { leftBound, newRightBound }))
-        {
-            cell->setState(SequencerCell::State::on)->setIsLeftConnected(true)->setIsRightConnected(true);
+    lastDragChangedWholeRow = false;
+    return changedColumns;
+}
 
-            if (column == leftBound)
-                cell->setIsLeftConnected(false);
-            if (column == leftOfNewRightBound)
-                cell->setIsRightConnected(false);
+void SequencerPanel::setCellAroundDraggedGreaterCell(const int& row, const int& column, const std::pair<int, int>& bounds, const std::pair<int, int>& snapshotBounds)
+{
+    const auto& [leftBound, rightBound] = bounds;
+    const auto& [snapshotLeftBound, snapshotRightBound] = snapshotBounds;
 
-            continue;
-        }
+    //1: do this if cell is part of the dragged greater cell
+    if (columnIsWithinBounds(column, bounds))
+    {
+        pattern.setCell(row, column, PatternModel::makeCell(true, column != leftBound, column != getLeftColumn(rightBound)));
+        return;
+    }
 
-        //2: do this if cell was only part of the dragged greater cell when dragging began
-        const auto& snapshotRightBound{ snapshotBounds.value().second };
-        if (greaterCellShrunk && columnIsWithinBounds(column, { newRightBound, snapshotRightBound }))
-        {
-            cell->turnOff();
-            continue;
-        }
+    //2: do this if cell was only part of the dragged greater cell when dragging began
+    if (isDraggingLeftCellEdge && columnIsWithinBounds(leftBound, snapshotBounds)
+        && columnIsWithinBounds(column, { snapshotLeftBound, getRightColumn(leftBound) }))
+    {
+        pattern.turnOff(row, column);
+        return;
+    }
 
-        //3: do this if neither conditions are met
-        cell->setCell(*rowSnapshot.getReference(column));
-        if (column == newRightBound)
-            cell->setIsLeftConnected(false);
+    if (isDraggingRightCellEdge && columnIsWithinBounds(rightBound, snapshotBounds)
+        && columnIsWithinBounds(column, { rightBound, snapshotRightBound }))
+    {
+        pattern.turnOff(row, column);
+        return;
     }
+
+    //3: do this if neither conditions are met
+    restoreCellFromRowSnapshot(row, column);
+    if (isDraggingLeftCellEdge && column == getLeftColumn(leftBound))
+        pattern.setIsRightConnected(row, column, false);
+    else if (isDraggingRightCellEdge && column == rightBound)
+        pattern.setIsLeftConnected(row, column, false);
 }
 
 void SequencerPanel::setTemplateRows(const int& newNumberOfVisibleRows)
@@ -1390,22 +1333,28 @@ void SequencerPanel::setTemplateRows(const int& newNumberOfVisibleRows)
 void SequencerPanel::handShallowCopying(const SequencerPanel& otherSequencerPanel)
 {
     mode = otherSequencerPanel.mode;
-    repeats = otherSequencerPanel.repeats;
-    startPositions = otherSequencerPanel.startPositions;
-    startPositions.minimiseStorageOverheads();
+    renderingMode = otherSequencerPanel.renderingMode;
+    if (&pattern != &otherSequencerPanel.pattern)
+        pattern.assign(otherSequencerPanel.pattern);
+    numberOfVisibleRows = otherSequencerPanel.numberOfVisibleRows;
     referenceRow = otherSequencerPanel.referenceRow;
     lastCellStateChange = otherSequencerPanel.lastCellStateChange;
-    lastOverCell = nullptr; //there is no need to deep copy this
-    mouseDownCell = nullptr; //there is no need to deep copy this
+    lastOverCell.reset(); //there is no need to deep copy this
+    mouseDownCell.reset(); //there is no need to deep copy this
     rowSnapshot.clear(); //there is no need to deep copy these
-    rowSnapshot.minimiseStorageOverheads();
+    lastDragChangedWholeRow = false;
+    rowSnapshotSpans.clear();
     isDraggingLeftCellEdge = otherSequencerPanel.isDraggingLeftCellEdge;
     isDraggingRightCellEdge = otherSequencerPanel.isDraggingLeftCellEdge;
     selectedCells.clear(); //there is no need to deep copy these
     selectedCells.minimiseStorageOverheads();
 
-    grid.templateColumns = otherSequencerPanel.grid.templateColumns;
-    grid.templateColumns.minimiseStorageOverheads();
+    columnLayout = otherSequencerPanel.columnLayout;
+    morph = otherSequencerPanel.morph;
+    morphTilt = otherSequencerPanel.morphTilt;
+    shownMorphVersion = otherSequencerPanel.shownMorphVersion;
+    morphedStartPositions = otherSequencerPanel.morphedStartPositions;
+    rowOffsets = otherSequencerPanel.rowOffsets;
     grid.templateRows = otherSequencerPanel.grid.templateRows;
     grid.templateRows.minimiseStorageOverheads();
 }
\ No newline at end of file
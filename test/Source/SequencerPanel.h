@@ -2,14 +2,21 @@
 
 #include <JuceHeader.h>
 #include "SequencerCell.h"
+#include "SequencerCellPool.h"
+#include "PatternModel.h"
+#include "TiltMorph.h"
+#include "ColumnLayout.h"
 #include "Globals.h"
 
-using Pattern = std::array<std::vector<std::shared_ptr<SequencerCell>>, CONSTANTS::MIDI_PITCHES_SIZE>;
+//the SequencerCells are owned by the panel's SequencerCellPool
+using CellMatrix = std::array<std::vector<SequencerCell*>, CONSTANTS::MIDI_PITCHES_SIZE>;
 
-//the central UI element in which the user may sequence their drum patern
+//the central UI element in which the user may sequence their drum patern. the panel is a view of a PatternModel it
+//doesn't own (the processor's), so it can be made and destroyed with the editor without copying the pattern
 //TODO: make this an abstract base and make there be two different specalised
 //classes for alpha/beta sequencers and tilt sequencer
 class SequencerPanel : public juce::Component
+                     , private juce::AsyncUpdater
 {
 public:
 
@@ -19,8 +26,20 @@ public:
         selectionMode = 1
     };
 
-    SequencerPanel(const int& initialVisibleRows);
+    //how the panel draws its cells. the editor's panel uses virtualisedRendering, componentRendering is kept as the
+    //fallback which virtualisedRendering's painting can be checked against (see setRenderingMode()), and is what a panel
+    //is made with unless it asks otherwise. only componentRendering has SequencerCells, so only it is affected by how
+    //many of them are created (see cellRowsMargin) and by where they are allocated (see SequencerCellPool)
+    enum RenderingMode
+    {
+        componentRendering = 0,     //the cells in the rows near the visible ones have SequencerCell child components, laid out by grid
+        virtualisedRendering = 1    //there are no SequencerCells, the panel paints only the visible cells itself from pattern
+    };
+
+    //patternToView must outlive the panel
+    SequencerPanel(PatternModel& patternToView, const int& initialVisibleRows, const RenderingMode& initialRenderingMode = componentRendering);
 
+    //the copy views the same pattern, whereas assigning a panel copies the pattern it views into the one this panel views
     SequencerPanel(const SequencerPanel& otherSequencerPanel);
 
     SequencerPanel(SequencerPanel&& otherSequencerPanel) noexcept;
@@ -51,31 +70,56 @@ public:
     void setNumberOfVisibleRows(const int& newVisibleRows);
 
     //returns the number of times the base columns layout is repeated
-    int getRepeats() const { return repeats; };
+    int getRepeats() const { return pattern.getRepeats(); };
 
-    //sets the number of times the base columns layout is repeated
+    //sets the number of times the base columns layout is repeated, clamped to [1, CONSTANTS::MAX_REPEATS]
     void setRepeats(const int& newRepeats);
 
-    //inserts a column onto the panel at startPosition and all repeats
-    void insertColumn(float startPosition);
+    //inserts a column onto the panel at startPosition (in ticks) and all repeats, unless a column already starts there.
+    //while a morph is shown startPosition only decides where the column goes among the others, it is drawn and played
+    //wherever the morph puts it
+    void insertColumn(const PatternModel::Tick& startPosition);
 
     //removes the column at index and all repeats
     void removeColumn(const int& index);
 
+    //structural edits (setRepeats, insertColumn, removeColumn and shiftStartPositions) made between these are
+    //applied to pattern straight away, but the SequencerCells, grid.items and layout are only brought up to date
+    //once, by the commitStructuralEdit() matching the outermost beginStructuralEdit()
+    void beginStructuralEdit();
+
+    void commitStructuralEdit();
+
     //returns the total number of columns currently in the grid
-    int columnsSize() const { return startPositions.size() * repeats; };
+    int columnsSize() const { return pattern.columnsSize(); };
     
     //returns the number of rows in the grid
-    int rowsSize() const { return pattern.size(); };
+    int rowsSize() const { return pattern.rowsSize(); };
 
-    //returns a copy of startPositions
-    juce::Array<float> getStartPositions() const { return startPositions; };
+    //returns a copy of startPositions, in ticks
+    juce::Array<PatternModel::Tick> getStartPositions() const { return pattern.getStartPositions(); };
 
     //returns the number of base columns (i.e. not counting repeats)
-    int baseColumnsSize() const { return startPositions.size(); };
+    int baseColumnsSize() const { return pattern.baseColumnsSize(); };
+
+    //returns the pattern this panel views
+    const PatternModel& getPattern() const { return pattern; };
+
+    //brings the panel up to date with its pattern after something other than the panel has changed it, e.g. the processor
+    //restoring a state. that change is not reported to onPatternChanged, whatever made it is responsible for it
+    void syncWithPattern();
+
+    //called on the message thread with pattern after it has been edited, at most once per message loop
+    std::function<void(const PatternModel&)> onPatternChanged;
+
+    //it is the responsiblity of the caller to ensure these are valid and in ascending order. ignored while a morph is
+    //shown, since the columns are played where the morph puts them, not at their start positions
+    void shiftStartPositions(juce::Array<PatternModel::Tick> newStartPositions);
 
-    //it is the responsiblity of the caller to ensure these are valid and in ascending order
-    void shiftStartPositions(juce::Array<float> newStartPositions);
+    //draws the columns where newMorph puts them at newTilt, i.e. where they are played, rather than at pattern's own start
+    //positions. only the drawing moves, pattern isn't edited. newMorph must outlive the panel, nullptr or an inactive morph
+    //draws the columns at pattern's start positions again
+    void showMorph(const TiltMorph* newMorph, const float& newTilt);
 
     //returns the minimum visible row (inclusive)
     int getReferenceRow() const { return referenceRow; };
@@ -83,193 +127,227 @@ public:
     //returns the maximum visible row (inclusive)
     int getVisibleRowsMax() const { return referenceRow + numberOfVisibleRows - 1; };
 
+    //returns the row at y on the panel, or nullopt if no row is there
+    std::optional<int> getRowAtY(const int& y) const;
+
+    //shows the note something other than the panel has recorded into pattern at (row, column) (see PatternModel::recordNote())
+    void showRecordedNote(const int& row, const int& column);
+
+    //returns true while an edge of a cell in row is being dragged, the drag rewrites row from how it was when it began, so
+    //anything else writing into row until then is lost
+    bool isDraggingRow(const int& row) const { return isDraggingCellEdge() && mouseDownCell.has_value() && mouseDownCell->first == row; };
+
     //shifts the visible rows up or down by shiftFactor
     void shiftVisibleRows(int shiftFactor = 1);
 
+    //shows newVisibleRows rows with newReferenceRow at the bottom, the rows must all exist
+    void setVisibleWindow(const int& newReferenceRow, const int& newVisibleRows);
+
     inline SequencerMode getMode() const { return mode; };
 
     void setMode(const SequencerMode& newMode);
+
+    inline RenderingMode getRenderingMode() const { return renderingMode; };
+
+    //switching to virtualisedRendering destroys every SequencerCell, switching back recreates them from pattern
+    void setRenderingMode(const RenderingMode& newRenderingMode);
 private:
-    Pattern pattern;
+    PatternModel& pattern;                                //the pattern this panel views and edits, the only place cell states are stored
+    RenderingMode renderingMode;                          //stores how the panel draws its cells (see enum RenderingMode)
+    juce::SharedResourcePointer<CellSpriteCache> spriteCache;   //the sprites cells are painted with, by the panel itself or by its SequencerCells
+    SequencerCellPool cellPool{ spriteCache.get() };      //every SequencerCell in cells comes from and goes back to this
+    CellMatrix cells;
     //a 2D matrix holding pointers to the SequencerCells which the grid formats on screen
     //Since juce::Grid stores GridItems in a 1D array, cells significantly simplifies
-    //the manipulation of GridItems and ensures non-visible cells are still stored
+    //the manipulation of GridItems
+    //only the rows from firstCellRow to lastCellRow (the visible rows and cellRowsMargin rows either side) have
+    //SequencerCells, the other rows are empty, and when the visible rows move the rows of SequencerCells which
+    //fall out of that window are recycled for the rows coming into it
     //generally, this means if you need to change the size of the rows in pattern
     //it is easier to do that before reflecting those changes in the grid
+    //cells is empty when renderingMode is virtualisedRendering
+    int firstCellRow{ 0 };                                //the first row with SequencerCells (inclusive)
+    int lastCellRow{ -1 };                                //the last row with SequencerCells (inclusive), less than firstCellRow if none have them
+    static constexpr int cellRowsMargin{ 4 };             //the number of rows either side of the visible rows which also have SequencerCells
 
     SequencerMode mode;                            //stores the input behaviour mode of the sequencer (see enum SequencerMode)
-    juce::Grid grid;                                      //the juce::Grid which handles the layout of Cells on screen
-    int repeats{ 1 };                                     //the number of times the base columns layout is repeated
-    juce::Array<float> startPositions{ 0 };               //the start positions of the base columns, in ascending order and in the range [0, 1)
+    juce::Grid grid;                                      //the juce::Grid whose items are the visible Cells, they are laid out by columnLayout
+    ColumnLayout columnLayout;                            //the x and width of every column, kept in step with pattern's columns
+    std::vector<int> rowOffsets;                          //the y of the top edge of each visible row (counted from the top) followed by the bottom edge of the last
     int numberOfVisibleRows{};                                    //the number of rows visible on screen at any time
     int referenceRow{ 60 };                               //the MIDI row which is at the bottom of the visible window (60 is C3)
 
     SequencerCell::State lastCellStateChange{ SequencerCell::State::off };  //stores the lastStateChange, used by mouseDown() and mouseDrag()
-    SequencerCell* lastOverCell{ nullptr };                                 //stores the last cell changed, used by mouseOver()
-    SequencerCell* mouseDownCell{ nullptr };                                //stores the last cell which received a mouseDown event, used by mouseDown() and mouseDrag()
-    juce::Array<std::unique_ptr<SequencerCell>> rowSnapshot;                //stores a "snapshot" of a row in cells, populated in mouseDown() when on a cell edge and cleared in mouseUp()
+    std::optional<std::pair<int, int>> lastOverCell;                        //stores the (row, column) of the last cell the mouse was over, used by mouseMove()
+    std::optional<std::pair<int, int>> mouseDownCell;                       //stores the (row, column) of the last cell which received a mouseDown event, used by mouseDown() and mouseDrag()
+    std::vector<PatternModel::Cell> rowSnapshot;                            //stores a "snapshot" of a row in pattern, populated in mouseDown() when on a cell edge and cleared in mouseUp()
+    PatternModel::NoteSpans rowSnapshotSpans;                               //the note spans of the row in rowSnapshot, taken at the same time
     bool isDraggingLeftCellEdge{ false };                                   //true only if the user is currently dragging a cell edge left
     bool isDraggingRightCellEdge{ false };                                  //true only if the user is currently dragging a cell edge right
-    juce::Array<std::shared_ptr<SequencerCell>> selectedCells;
-
-    bool startPositionsIsValid(const juce::Array<float>& posiblyInvalidStartPositions) const;
+    bool lastDragChangedWholeRow{ false };                                  //true if the last drag event changed the dragged row beyond the dragged greater cell (see handleDragEdgeOfNonGreaterCell())
+    juce::Array<std::pair<int, int>> selectedCells;
+    int structuralEditDepth{ 0 };                                           //the number of calls to beginStructuralEdit() not yet committed
+    bool columnsNeedLayingOut{ false };                                     //true if a structural edit since the outermost beginStructuralEdit() moved every column's edge
+    juce::Rectangle<int> dirtyRegion;                                       //the union of the bounds of every cell refreshed since the panel was last repainted
+    std::uint32_t notifiedPatternVersion{ 0 };                              //the version of pattern onPatternChanged was last called with
+    const TiltMorph* morph{ nullptr };                                      //the morph the columns are drawn at (see showMorph()), nullptr if none
+    float morphTilt{ 0.f };                                                 //the tilt the columns are drawn at on morph
+    std::uint32_t shownMorphVersion{ 0 };                                   //the version of morph when the columns were last laid out on it
+    juce::Array<PatternModel::Tick> morphedStartPositions;                  //the base columns' start positions on morph at morphTilt, empty if it isn't shown
 
     //returns a raw pointer to a grid item which could be nullptr
-    const juce::GridItem* findGridItemPointer(const std::shared_ptr<SequencerCell>& cell) const;
+    const juce::GridItem* findGridItemPointer(const SequencerCell* cell) const;
 
     //does no bounds checking ;D
-    std::shared_ptr<SequencerCell> getCellInPattern(const int& row, const int& column) const { return pattern[row][column]; };
+    SequencerCell* getCellInCells(const int& row, const int& column) const { return cells[row][column]; };
 
-    //does no bounds checking and could be null ;D
-    SequencerCell* getCellPtr(const int& row, const int& column) const { return pattern[row][column].get(); };
+    //does no bounds checking and could be null ;D, row must have SequencerCells (see rowHasCells())
+    SequencerCell* getCellPtr(const int& row, const int& column) const { return cells[row][column]; };
 
-    //adds a column at the end of the grid
-    void addCell();
+    //returns true if row has SequencerCells, which is only so for the rows near the visible ones in componentRendering
+    bool rowHasCells(const int& row) const { return row >= firstCellRow && row <= lastCellRow; };
 
-    //inserts a column at index in the grid
-    void insertCell(const int& index);
+    //copies the state of the cell at (row, column) in pattern onto its SequencerCell, without repainting it
+    void syncCell(const int& row, const int& column);
 
-    //finds all cells in the grid to be removed, and removes them
-    void removeLastColumns(const int& numberOfCellsToRemove);
+    //syncs the SequencerCell at (row, column) with pattern and, if it is visible, adds its bounds to dirtyRegion
+    void refreshCell(const int& row, const int& column);
 
-    //finds all cells in the grid to be removed, and removes them
-    void removeCell(const int& index);
+    //adds bounds to dirtyRegion, which is repainted as one rectangle by handleAsyncUpdate()
+    void markDirty(const juce::Rectangle<int>& bounds);
 
-    //finds the index of a position if it were inserted into startPositions
-    //this can cause problems if it returns 0 (which it never should)
-    int findIndex(const float& startPosition);
+    //repaints dirtyRegion and empties it, so the cells changed by any number of edits are repainted once per message loop,
+    //then calls onPatternChanged if pattern has been edited since it was last called
+    void handleAsyncUpdate() override;
 
-    //because start positions are visible to the user, they can be greater than 1.f
-    //helpfully, this function returns repeats as a float if index is equal to
-    //baseWidths.size() * repeats
-    float columnStartPosition(const int& index) const;
+    //syncs every SequencerCell with pattern and repaints the panel
+    void refreshAllCells();
 
-    //returns the width of a column as a fraction of the total width of the grid
-    float columnWidth(const int& index) const;
+    //creates a SequencerCell for every cell in the rows near the visible ones and fills grid.items with the visible ones
+    void createCells();
 
-    //returns the width of a column as a number of pixels
-    int columnWidthAsGridFr(const int& index) const;
+    //removes and destroys every SequencerCell and empties grid.items
+    void destroyCells();
 
-    //updates grid.templateColumns to match the current columns
-    void updateTemplateColumns();
+    //paints the cells overlapping the clip region of g straight from pattern, used when renderingMode is virtualisedRendering
+    void paintVisibleCells(juce::Graphics& g) const;
 
-    //helper function for refreshTemplateColumns
-    void makeIdealWidths(std::vector<int>& newTemplateColumns) const;
+    //adds or removes SequencerCells at the end of every row which has them so there is one for each column in pattern,
+    //then refills grid.items. SequencerCells only view pattern, so they are never moved between
+    //columns, they are synced with whatever column they end up at instead
+    void resizeRowsOfCells();
 
-    //helper function for refreshTemplateColumns
-    void distributeError(std::vector<int>& newTemplateColumns) const;
+    //as above but for the one row, without refilling grid.items
+    void resizeRowOfCells(const int& row);
 
-    //returns the index in grid.items of the cell at (row, column).
-    //row and column refer to the visible rows and columns, rather
-    //than the absolute rows and columns
-    int gridItemsIndex(const int& row, const int& column) const;
+    //componentRendering only, since only it has SequencerCells: moves firstCellRow and lastCellRow to surround the visible
+    //rows, giving the rows of SequencerCells which fall out of the window to the rows coming into it (synced with them, and
+    //hidden) and only creating SequencerCells if there aren't enough rows to recycle. grid.items must be refilled after this
+    void moveCellRowsToVisibleRows();
 
-    //returns the absolute (row, column) of the cell at grid.items index
-    std::pair<int, int> gridItemsCoordinates(const int& gridItemsIndex) const;
-
-    //returns the absolute (row, column) of this cell
-    std::optional<std::pair<int, int>> getCellCoordinates(const SequencerCell* const cell) const;
+    //lays out every column in columnLayout from scratch, call this when the width or repeats change
+    void layOutColumns();
 
-    std::optional<int> getCellRow(const SequencerCell* const cell) const;
+    //returns true if the columns are drawn at a morph rather than at pattern's start positions
+    bool isShowingMorph() const { return morph != nullptr && morph->isActive(); };
 
-    std::optional<int> getCellColumn(const SequencerCell* const cell) const;
-
-    //returns 2D cells matrix as a vector for ease of itteration
-    std::vector<std::shared_ptr<SequencerCell>> cellsAsVector() const;
+    //returns where column is drawn from, in ticks: its start position on the morph if one is shown, otherwise in pattern
+    PatternModel::Tick getDrawnStartPosition(const int& column) const;
 
-    //returns a pointer to the cell at location, or nullptr if no cell is there
-    SequencerCell* getCellAtLocation(const juce::Point<int>& location);
+    //sets the bounds of the visible SequencerCells from columnLayout and rowOffsets, or repaints
+    //the panel if renderingMode is virtualisedRendering
+    void layOutCells();
 
-    //returns bounds of left edge of cell
-    juce::Rectangle<int> getLeftEdgeBounds(const SequencerCell* const cell) const;
+    //updates rowOffsets to match the current height and number of visible rows
+    void updateRowOffsets();
 
-    //returns bounds of right edge of cell
-    juce::Rectangle<int> getRightEdgeBounds(const SequencerCell* const cell) const;
+    //returns true if columnLayout and rowOffsets match the current columns and visible rows
+    bool offsetsAreUpToDate() const;
 
-    //returns a pointer to the cell to the left of cell, or nullptr if there is none (though that shouldn't happen)
-    SequencerCell* getLeftCell(const SequencerCell* const cell, const int& steps = 1) const;
+    //returns the absolute (row, column) of the cell at grid.items index
+    std::pair<int, int> gridItemsCoordinates(const int& gridItemsIndex) const;
 
-    int getLeftColumn(const int& column, const int& steps = 1) const { return CUSTOM_FUNCTIONS::positiveMod(column - steps, columnsSize()); };
+    //returns 2D cells matrix as a vector for ease of itteration
+    std::vector<SequencerCell*> cellsAsVector() const;
 
-    //returns a pointer to the cell to the right of cell, or nullptr if there is none (though that shouldn't happen)
-    SequencerCell* getRightCell(const SequencerCell* const cell, const int& steps = 1) const;
+    //returns the (row, column) of the cell at location, or nullopt if no cell is there
+    //this binary searches columnLayout for the column and rowOffsets for the row
+    std::optional<std::pair<int, int>> getCellCoordinatesAtLocation(const juce::Point<int>& location) const;
 
-    int getRightColumn(const int& column, const int& steps = 1) const { return CUSTOM_FUNCTIONS::positiveMod(column + steps, columnsSize()); };
+    //returns true if row is within the visible rows
+    bool rowIsVisible(const int& row) const { return row >= referenceRow && row <= getVisibleRowsMax(); };
 
-    //toggles the state of cell and updates lastCellStateChange
-    SequencerCell* changeCellState(SequencerCell* const cell);
+    //returns the bounds of the cell at (row, column) on the panel, the row must be visible
+    juce::Rectangle<int> getCellBounds(const int& row, const int& column) const;
 
-    //sets the state of cell to newState without changing lastCellStateChange
-    SequencerCell* setCellState(SequencerCell* const cell, const SequencerCell::State& newState);
+    //returns bounds of left edge of the cell at (row, column)
+    juce::Rectangle<int> getLeftEdgeBounds(const int& row, const int& column) const;
 
-    //sets lastCellOver to nullptr
-    void exitLastCellOver();
+    //returns bounds of right edge of the cell at (row, column)
+    juce::Rectangle<int> getRightEdgeBounds(const int& row, const int& column) const;
 
-    bool eventIsContainedByADraggableLeftEdge(const SequencerCell* const cell, const juce::Point<int>& eventPosition) const;
+    int getLeftColumn(const int& column, const int& steps = 1) const { return CUSTOM_FUNCTIONS::positiveMod(column - steps, columnsSize()); };
 
-    bool eventIsContainedByADraggableRightEdge(const SequencerCell* const cell, const juce::Point<int>& eventPosition) const;
+    int getRightColumn(const int& column, const int& steps = 1) const { return CUSTOM_FUNCTIONS::positiveMod(column + steps, columnsSize()); };
 
-    //returns true if the mouse is over an edge of cell
-    bool eventIsContainedByADraggableEdge(const SequencerCell* const cell, const juce::Point<int>& eventPosition) const;
+    //toggles the state of the cell at (row, column) in pattern
+    void changeCellState(const int& row, const int& column);
 
-    //updates lastCellOver to cell
-    void updateLastCellOver(SequencerCell* const cell);
+    //sets the state of the cell at (row, column) in pattern to newState without changing lastCellStateChange
+    void setCellState(const int& row, const int& column, const SequencerCell::State& newState);
 
-    //shifts the grid item at itemIndex up or down by shiftFactor number of rows in grid.items
-    void shiftGridItem(const int& itemIndex, const int& shiftFactor);
+    //stops showing the mouse over lastCellOver and resets it
+    void exitLastCellOver();
 
-    //helper function called by setRepeats when newRepeats < repeats
-    void handleNewRepeatsIsGreaterThanOld(const int& newRepeats);
+    bool eventIsContainedByADraggableLeftEdge(const int& row, const int& column, const juce::Point<int>& eventPosition) const;
 
-    //helper function called by addCell, handles the addition of a cell and it's effect the Cells matrix
-    void handleAdditionOfCellToPattern(const int& row, const std::shared_ptr<SequencerCell>& cell);
+    bool eventIsContainedByADraggableRightEdge(const int& row, const int& column, const juce::Point<int>& eventPosition) const;
 
-    //helper function called by insertCell, handles the insertion of a cell and it's effect the Cells matrix
-    void handleInsertionOfCellToPattern(const int& row, const int& column, const int& preInsertionColumnsSize);
+    //returns true if the mouse is over an edge of the cell at (row, column)
+    bool eventIsContainedByADraggableEdge(const int& row, const int& column, const juce::Point<int>& eventPosition) const;
 
-    //helper function called by handleInsertionOfCellToCells, handles how connections respond when a cell is inserted
-    void handleCellConnectionsDuringInsertion(const int& row, const int& column, const int& preInsertionColumnsSize);
+    //updates lastCellOver to (row, column)
+    void updateLastCellOver(const int& row, const int& column);
 
-    //helper function called by insertCell, handles the removal of a cell and it's effect the Cells matrix and grid.items
-    void handleRemovalOfCellFromCells(const int& row, const int& column, const int& preRemovalColumnsSize);
+    //helper function called by resizeRowsOfCells, handles the addition of a cell and it's effect the Cells matrix
+    void handleAdditionOfCellToCells(const int& row, SequencerCell* cell);
 
-    //helper function called by handleRemovalOfCellFromCells,  handles how connections respond when a cell is removed
-    void handleCellConnectionsDuringRemoval(const int& row, const int& column, const int& preRemovalColumnsSize);
+    //stops cell being a child of the panel and gives it back to cellPool, it must be removed from cells too
+    void handleRemovalOfCell(SequencerCell* cell);
 
-    //takes a snapshot of a row which is stored as new unique pointers in rowSnapshot
+    //takes a snapshot of a row which is stored as cell values in rowSnapshot
     void snapshotRow(const int& row);
 
+    //sets the cell at (row, column) in pattern to its state in rowSnapshot
+    void restoreCellFromRowSnapshot(const int& row, const int& column);
+
     bool isDraggingCellEdge() const { return isDraggingLeftCellEdge || isDraggingRightCellEdge; };
 
     //call this after dragging stops, sets dragging states to false and empties rowSnapshot
     void resetDraggingStates();
 
-    //give whatever cell is being dragged a new left bound
-    void setDraggedGreaterCellLeftBound(const int& row, const std::pair<int, int>& oldBounds, const int& newLeftBound);
+    //give whatever cell is being dragged a new left bound, only the columns from left of the further left of the old and
+    //new left bounds to the nearer one can change, returns those columns (both inclusive) or nullopt if nothing changed
+    std::optional<std::pair<int, int>> setDraggedGreaterCellLeftBound(const int& row, const std::pair<int, int>& oldBounds, const int& newLeftBound);
 
-    //give whatever cell is being dragged a new right bound
-    void setDraggedGreaterCellRightBound(const int& row, const std::pair<int, int>& oldBounds, const int& newRightBound);
+    //give whatever cell is being dragged a new right bound, only the columns from left of the nearer of the old and new
+    //right bounds to the further one can change, returns those columns (both inclusive) or nullopt if nothing changed
+    std::optional<std::pair<int, int>> setDraggedGreaterCellRightBound(const int& row, const std::pair<int, int>& oldBounds, const int& newRightBound);
 
-    //connects the whole row, this actually puts the row in an invalid state since there is no note beginning
-    void connectWholeRow(const int& row);
-
-    //find the index of a cell in grid items, returns nullopt if cell is not in grid items
-    std::optional<int> findGridItemIndex(const std::shared_ptr<SequencerCell>& cell) const;
+    //sets the cell at column in row as if the dragged greater cell were [leftBound, rightBound), given the bounds it had in rowSnapshot
+    void setCellAroundDraggedGreaterCell(const int& row, const int& column, const std::pair<int, int>& bounds, const std::pair<int, int>& snapshotBounds);
 
     //if dragging left and dragPosition is left of middle of cell then make the "greater" cell occupy only one cell,
     //else it is right of middle of cell and makes the greater cell occupy the whole row
     //if dragging right and dragPosition is right of middle of cell then make the "greater" cell occupy only one cell,
     //else it is left of middle of cell and makes the greater cell occupy the whole row
-    void handleDragEdgeOfNonGreaterCell(SequencerCell* const cell, const juce::Point<int> dragPosition);
-
-    //returned bound is inclusive
-    std::optional<int> getLeftBoundOfGreaterCellContainingCell(const SequencerCell* const cell) const;
+    void handleDragEdgeOfNonGreaterCell(const int& row, const int& column, const juce::Point<int> dragPosition);
 
-    //returned bound is exclusive
-    std::optional<int> getRightBoundOfGreaterCellContainingCell(const SequencerCell* const cell) const;
+    //returned bound is inclusive, found from the row's note spans in O(log n)
+    std::optional<int> getLeftBoundOfGreaterCellContainingCell(const int& row, const int& column) const;
 
-    //the returned tupple<int, int, int> indicate the row, left bound, and right bound of the cell if it exists in cells, otherwise nullopt
-    std::optional<std::tuple<int, int, int>> getCoordinatesOfGreaterCellContainingCell(const SequencerCell* const cell) const;
+    //returned bound is exclusive, found from the row's note spans in O(log n)
+    std::optional<int> getRightBoundOfGreaterCellContainingCell(const int& row, const int& column) const;
 
     //returns the left bound of  cell if it exists in cells, otherwise nullopt
     std::optional<int> getLeftBoundOfGreaterCellAtColumnInRowSnapshot(const int& column) const;
@@ -293,21 +371,21 @@ private:
     bool rowIsInValidState(const int& row) const;
 
     //called by mouseDrag() when isDraggingLeftCellEdge = true
-    void handleDraggingLeftCellEdge(SequencerCell* const cell, const juce::Point<int>& dragPosition,
-        const int& row, const std::pair<int, int>& currentBounds, const int& newLeftBound);
+    void handleDraggingLeftCellEdge(const int& row, const int& column, const juce::Point<int>& dragPosition,
+        const std::pair<int, int>& currentBounds, const int& newLeftBound);
 
     //called by mouseDrag() when isDraggingRightCellEdge = true
-    void handleDraggingRightCellEdge(SequencerCell* const cell, const juce::Point<int>& dragPosition,
-        const int& row, const std::pair<int, int>& currentBounds, const int& newRightBound);
+    void handleDraggingRightCellEdge(const int& row, const int& column, const juce::Point<int>& dragPosition,
+        const std::pair<int, int>& currentBounds, const int& newRightBound);
 
     //the returned pair<int, int> represents leftBound and rightBounds, bounds are live in the sense that a cell may be dragged when this is called
     //row is the row in cells where this greater cell is and column is a column which is contained by a greater cell
     std::optional<std::pair<int, int>> getLiveBoundsOfGreaterCell(const int& row, const int& column) const;
 
-    //repaints a whole row in pattern
+    //syncs and marks dirty a whole row in pattern
     void repaintRow(const int& row);
 
-    //repaints the area within the coordinates, inclusive of leftBound and topBound, exclusive of rightBound and bottomBound
+    //syncs and marks dirty the area within the coordinates, inclusive of leftBound and topBound, exclusive of rightBound and bottomBound
     void repaintRegion(const int& leftBound, const int& rightBound, const int& topBound, const int& bottomBound);
 
     //shuffles a row in pattern
@@ -141,7 +141,7 @@ void SequencerStrip::setColumns(const int& newColumns)
         for (auto column{ oldColumns }; column != newColumns; ++column)
         {
             gridColumns.add(grid.autoRows);
-            gridItems.add(new SequencerCell);
+            gridItems.add(new SequencerCell(spriteCache.get()));
 			auto& cell{ gridItems.getReference(column).associatedComponent };
 
             addAndMakeVisible(cell);
@@ -164,6 +164,21 @@ void SequencerStrip::setColumns(const int& newColumns)
         gridItems.resize(newColumns);
         gridItems.minimiseStorageOverheads();
     }
+
+    layOutCells();
+}
+
+juce::Array<PatternModel::Tick> SequencerStrip::getStartPositions() const
+{
+    const auto columns{ grid.items.size() };
+
+    juce::Array<PatternModel::Tick> startPositions;
+    startPositions.ensureStorageAllocated(columns);
+
+    for (auto column{ 0 }; column != columns; ++column)
+        startPositions.add(column * CONSTANTS::TICKS_PER_REPEAT / columns);
+
+    return startPositions;
 }
 
 void SequencerStrip::paint(juce::Graphics& g)
@@ -173,5 +188,19 @@ void SequencerStrip::paint(juce::Graphics& g)
 
 void SequencerStrip::resized()
 {
-	grid.performLayout(getLocalBounds());
+	layOutCells();
+}
+
+void SequencerStrip::layOutCells()
+{
+    const auto columns{ grid.items.size() };
+
+    std::vector<int> columnStartPositions(static_cast<size_t>(columns));
+    std::iota(columnStartPositions.begin(), columnStartPositions.end(), 0);
+
+    columnLayout.layOut(std::move(columnStartPositions), std::max(columns, 1), getWidth());
+
+    for (auto column{ 0 }; column != columns; ++column)
+        grid.items.getReference(column).associatedComponent->setBounds(columnLayout.getX(column), 0,
+                                                                        columnLayout.getWidth(column), getHeight());
 }
\ No newline at end of file
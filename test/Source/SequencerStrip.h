@@ -1,6 +1,8 @@
 #pragma once
 #include <JuceHeader.h>
 #include "SequencerCell.h"
+#include "ColumnLayout.h"
+#include "PatternModel.h"
 
 class SequencerStrip : public juce::Component
 {
@@ -21,10 +23,18 @@ public:
 
 	void setColumns(const int& newColumns);
 
+	//returns the start positions of the columns in ticks, which divide a repeat evenly
+	juce::Array<PatternModel::Tick> getStartPositions() const;
+
 	void paint(juce::Graphics& g) override;
 
 	void resized() override;
 
+	//lays out the columns, which are all the same width, and sets the bounds of the cells from them
+	void layOutCells();
+
 private:
-	juce::Grid grid;
+	juce::Grid grid;	//the juce::Grid whose items are the cells, they are laid out by columnLayout
+	ColumnLayout columnLayout;
+	juce::SharedResourcePointer<CellSpriteCache> spriteCache;	//shared with the cells
 };
\ No newline at end of file
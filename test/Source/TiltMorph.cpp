@@ -0,0 +1,82 @@
+#include "TiltMorph.h"
+
+void TiltMorph::setGrids(juce::Array<Tick> newAlphaGrid, juce::Array<Tick> newBetaGrid)
+{
+    jassert(newAlphaGrid.isEmpty() || newAlphaGrid.getFirst() == 0);
+    jassert(newBetaGrid.isEmpty() || newBetaGrid.getFirst() == 0);
+
+    //the version only moves if the grids do, so schedules compiled with them aren't compiled again for nothing
+    if (newAlphaGrid == alphaGrid && newBetaGrid == betaGrid)
+        return;
+
+    alphaGrid = std::move(newAlphaGrid);
+    betaGrid = std::move(newBetaGrid);
+    ++version;
+}
+
+juce::Array<TiltMorph::Tick> TiltMorph::makeEvenGrid(const int& columns)
+{
+    juce::Array<Tick> grid;
+    grid.ensureStorageAllocated(columns);
+
+    for (auto column{ 0 }; column != columns; ++column)
+        grid.add(column * CONSTANTS::TICKS_PER_REPEAT / columns);
+
+    return grid;
+}
+
+void TiltMorph::makeTables(const int& baseColumnsSize, std::vector<float>& alphaStartPositions, std::vector<float>& betaMinusAlpha) const
+{
+    alphaStartPositions.resize(static_cast<size_t>(baseColumnsSize));
+    betaMinusAlpha.resize(static_cast<size_t>(baseColumnsSize));
+
+    for (auto column{ 0 }; column != baseColumnsSize; ++column)
+    {
+        const auto alphaStartPosition{ placeOnGrid(alphaGrid, column, baseColumnsSize) };
+
+        alphaStartPositions[column] = static_cast<float>(alphaStartPosition);
+        betaMinusAlpha[column] = static_cast<float>(placeOnGrid(betaGrid, column, baseColumnsSize) - alphaStartPosition);
+    }
+}
+
+void TiltMorph::evaluate(const float& tilt, const std::vector<float>& alphaStartPositions, const std::vector<float>& betaMinusAlpha, float* destination)
+{
+    jassert(alphaStartPositions.size() == betaMinusAlpha.size());
+
+    const auto size{ static_cast<int>(alphaStartPositions.size()) };
+
+    juce::FloatVectorOperations::copy(destination, alphaStartPositions.data(), size);
+    juce::FloatVectorOperations::addWithMultiply(destination, betaMinusAlpha.data(), tilt, size);
+}
+
+juce::Array<TiltMorph::Tick> TiltMorph::getStartPositions(const float& tilt, const int& baseColumnsSize) const
+{
+    std::vector<float> alphaStartPositions, betaMinusAlpha;
+    makeTables(baseColumnsSize, alphaStartPositions, betaMinusAlpha);
+
+    std::vector<float> startPositions(alphaStartPositions.size());
+    evaluate(tilt, alphaStartPositions, betaMinusAlpha, startPositions.data());
+
+    juce::Array<Tick> newStartPositions;
+    newStartPositions.ensureStorageAllocated(baseColumnsSize);
+
+    for (auto column{ 0 }; column < baseColumnsSize; ++column)
+        newStartPositions.add(juce::roundToInt(startPositions[column]));
+
+    return newStartPositions;
+}
+
+TiltMorph::Tick TiltMorph::placeOnGrid(const juce::Array<Tick>& grid, const int& column, const int& baseColumnsSize)
+{
+    const auto steps{ grid.size() };
+    const auto step{ column * steps / baseColumnsSize };
+
+    //the columns sharing step are [firstColumn, firstColumn + columnsOnStep)
+    const auto firstColumn{ (step * baseColumnsSize + steps - 1) / steps };
+    const auto columnsOnStep{ ((step + 1) * baseColumnsSize + steps - 1) / steps - firstColumn };
+
+    const auto stepStart{ grid.getUnchecked(step) };
+    const auto stepEnd{ step + 1 < steps ? grid.getUnchecked(step + 1) : CONSTANTS::TICKS_PER_REPEAT };
+
+    return stepStart + (stepEnd - stepStart) * (column - firstColumn) / columnsOnStep;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PatternModel.h"
+#include "Globals.h"
+
+//morphs the start positions of the tilt SequencerPanel's base columns between the rhythmic grids of the alpha and beta
+//SequencerStrips. at a tilt of 0 every column sits on the alpha grid and at a tilt of 1 on the beta grid: if there are no more
+//columns than grid steps, column i snaps to step floor(i * steps / columns), otherwise the columns on the same step share it
+//evenly. in between, each column moves in a straight line, so a start position is alpha + tilt * (beta - alpha). alpha and
+//(beta - alpha) are tabulated once, so evaluating every column at a new tilt costs two vector operations.
+//since both ends are ascending, every tilt in between is too, so the columns never cross
+class TiltMorph
+{
+public:
+    using Tick = PatternModel::Tick;
+
+    TiltMorph() = default;
+
+    //sets the grids to morph between, the start positions of the columns of one repeat of each strip in ticks, ascending and
+    //starting at 0. either being empty means there is nothing to morph between
+    void setGrids(juce::Array<Tick> newAlphaGrid, juce::Array<Tick> newBetaGrid);
+
+    //returns a grid of columns evenly spaced columns, like those of a SequencerStrip
+    static juce::Array<Tick> makeEvenGrid(const int& columns);
+
+    //returns true if there are grids to morph between
+    bool isActive() const { return !alphaGrid.isEmpty() && !betaGrid.isEmpty(); };
+
+    //returns a number which changes every time the grids change
+    std::uint32_t getVersion() const { return version; };
+
+    //fills the tables of baseColumnsSize columns: where each starts on the alpha grid, and how far it is from there to the beta grid
+    void makeTables(const int& baseColumnsSize, std::vector<float>& alphaStartPositions, std::vector<float>& betaMinusAlpha) const;
+
+    //destination[i] = alphaStartPositions[i] + tilt * betaMinusAlpha[i] for the size of the tables
+    static void evaluate(const float& tilt, const std::vector<float>& alphaStartPositions, const std::vector<float>& betaMinusAlpha, float* destination);
+
+    //returns the start positions of baseColumnsSize columns at tilt rounded to ticks, for drawing the columns where they are played
+    juce::Array<Tick> getStartPositions(const float& tilt, const int& baseColumnsSize) const;
+
+private:
+    juce::Array<Tick> alphaGrid;
+    juce::Array<Tick> betaGrid;
+    std::uint32_t version{ 0 };
+
+    //returns where column of baseColumnsSize columns starts on grid
+    static Tick placeOnGrid(const juce::Array<Tick>& grid, const int& column, const int& baseColumnsSize);
+};
@@ -0,0 +1,14 @@
+#include <JuceHeader.h>
+
+//runs the plugin's unit tests, returning 1 if any of them fail
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.runTestsInCategory("TiltSequencer");
+
+    for (auto result{ 0 }; result != runner.getNumResults(); ++result)
+        if (runner.getResult(result)->failures > 0)
+            return 1;
+
+    return 0;
+}
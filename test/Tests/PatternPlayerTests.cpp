@@ -0,0 +1,191 @@
+#include <JuceHeader.h>
+#include "../Source/PatternPlayer.h"
+#include "../Source/PatternCompiler.h"
+
+//plays a pattern block by block against a scripted host and checks the sample every note-on and note-off lands on while
+//the host plays straight through, loops, relocates and changes tempo. at 120 bpm and 48kHz a quarter note is 24000 samples,
+//and each of the pattern's 4 columns lasts one: row 60 is on in column 0 and row 62 in column 2
+class PatternPlayerTests : public juce::UnitTest
+{
+public:
+    PatternPlayerTests() : juce::UnitTest("PatternPlayer host following", "TiltSequencer") {}
+
+    void runTest() override
+    {
+        const auto schedule{ makeSchedule() };
+
+        beginTest("Plays straight through");
+        {
+            Performance performance;
+            performance.play(*schedule, 196, 512);
+
+            expectEquals(describe(performance.notes), describe({ { 0, 60, true }, { 24000, 60, false }, { 48000, 62, true },
+                                                                 { 72000, 62, false }, { 96000, 60, true } }));
+        }
+
+        beginTest("Loops inside a block");
+        {
+            //the loop ends 320 samples into the 141st block, which ends the note sounding there and plays from loopStart
+            Performance performance;
+            performance.playHead.info.setIsLooping(true);
+            performance.playHead.info.setLoopPoints(juce::AudioPlayHead::LoopPoints{ 0.0, 3.0 });
+            performance.play(*schedule, 196, 512);
+
+            expectEquals(describe(performance.notes), describe({ { 0, 60, true }, { 24000, 60, false }, { 48000, 62, true },
+                                                                 { 72000, 62, false }, { 72000, 60, true }, { 96000, 60, false } }));
+        }
+
+        beginTest("Relocates");
+        {
+            //the host jumps to the start of column 2, which ends row 60's note and plays row 62's at once
+            Performance performance;
+            performance.play(*schedule, 4, 512);
+            performance.playHead.info.setPpqPosition(2.0);
+            performance.play(*schedule, 4, 512);
+
+            expectEquals(describe(performance.notes), describe({ { 0, 60, true }, { 2048, 60, false }, { 2048, 62, true } }));
+        }
+
+        beginTest("Follows a tempo change");
+        {
+            //from the second quarter note on, each lasts twice as long
+            Performance performance;
+            performance.play(*schedule, 50, 480);
+            performance.playHead.info.setBpm(60.0);
+            performance.play(*schedule, 250, 480);
+
+            expectEquals(describe(performance.notes), describe({ { 0, 60, true }, { 24000, 60, false }, { 72000, 62, true },
+                                                                 { 120000, 62, false } }));
+        }
+
+        beginTest("Ends a note with the next note-on in its row");
+        {
+            //row 64 has a note in column 0 and another in column 1, and row 65 a note covering the whole row, neither of
+            //which has a note-off of its own where the next note starts
+            PatternModel pattern;
+
+            for (auto column{ 1 }; column != 4; ++column)
+                pattern.insertColumn(column * CONSTANTS::TICKS_PER_REPEAT / 4);
+
+            pattern.setState(64, 0, true);
+            pattern.setState(64, 1, true);
+
+            for (auto column{ 0 }; column != 4; ++column)
+            {
+                pattern.setState(65, column, true);
+                pattern.setIsLeftConnected(65, column, true);
+                pattern.setIsRightConnected(65, column, true);
+            }
+
+            pattern.setIsLeftConnected(65, 0, false);
+            pattern.setIsRightConnected(65, 3, false);
+
+            PatternCompiler compiler;
+            const auto backToBackSchedule{ compiler.compile(pattern, TiltMorph()) };
+            expectEquals(static_cast<int>(backToBackSchedule->getEvents().size()), 4);
+
+            Performance performance;
+            performance.play(*backToBackSchedule, 196, 512);
+
+            expectEquals(describe(performance.notes), describe({ { 0, 64, true }, { 0, 65, true }, { 24000, 64, false },
+                                                                 { 24000, 64, true }, { 48000, 64, false }, { 96000, 64, true },
+                                                                 { 96000, 65, false }, { 96000, 65, true } }));
+        }
+    }
+
+private:
+    static constexpr double sampleRate{ 48000.0 };
+
+    //a note-on or note-off at the sample it was played at, counted from the start of playback
+    struct Note
+    {
+        int sample;
+        int pitch;
+        bool isNoteOn;
+    };
+
+    //reports the position, tempo and loop it is set to, and moves on after each block the way a host's transport does
+    struct ScriptedPlayHead : public juce::AudioPlayHead
+    {
+        PositionInfo info;
+
+        juce::Optional<PositionInfo> getPosition() const override { return info; };
+
+        void advance(const int& numSamples)
+        {
+            auto ppqPosition{ *info.getPpqPosition() + numSamples * *info.getBpm() / 60.0 / sampleRate };
+
+            if (const auto loopPoints{ info.getLoopPoints() })
+                if (info.getIsLooping() && ppqPosition >= loopPoints->ppqEnd)
+                    ppqPosition = loopPoints->ppqStart + (ppqPosition - loopPoints->ppqEnd);
+
+            info.setPpqPosition(ppqPosition);
+        };
+    };
+
+    //a player following a ScriptedPlayHead from the start of playback at 120 bpm, and the notes it has played
+    struct Performance
+    {
+        PatternPlayer player;
+        ScriptedPlayHead playHead;
+        std::vector<Note> notes;
+        int playedSamples{ 0 };
+
+        Performance()
+        {
+            player.prepare(sampleRate);
+            playHead.info.setIsPlaying(true);
+            playHead.info.setBpm(120.0);
+            playHead.info.setPpqPosition(0.0);
+        };
+
+        //plays blocks blocks of blockSize samples, the transport is taken from playHead for each as processBlock() does
+        void play(const PatternSchedule& schedule, const int& blocks, const int& blockSize)
+        {
+            for (auto block{ 0 }; block != blocks; ++block)
+            {
+                juce::MidiBuffer midiMessages;
+
+                if (const auto transport{ PatternPlayer::getHostTransport(&playHead) })
+                    player.renderNextBlock(schedule, *transport, midiMessages, 0, blockSize);
+
+                for (const auto metadata : midiMessages)
+                {
+                    const auto message{ metadata.getMessage() };
+                    notes.push_back({ playedSamples + metadata.samplePosition, message.getNoteNumber(), message.isNoteOn() });
+                }
+
+                playedSamples += blockSize;
+                playHead.advance(blockSize);
+            }
+        };
+    };
+
+    //4 columns a quarter note long, with a note of one column in row 60 at column 0 and in row 62 at column 2
+    static std::unique_ptr<PatternSchedule> makeSchedule()
+    {
+        PatternModel pattern;
+
+        for (auto column{ 1 }; column != 4; ++column)
+            pattern.insertColumn(column * CONSTANTS::TICKS_PER_REPEAT / 4);
+
+        pattern.setState(60, 0, true);
+        pattern.setState(62, 2, true);
+
+        PatternCompiler compiler;
+        return compiler.compile(pattern, TiltMorph());
+    }
+
+    //the notes in the order they were played, so a failure shows where they differ
+    static juce::String describe(const std::vector<Note>& notes)
+    {
+        juce::StringArray descriptions;
+
+        for (const auto& note : notes)
+            descriptions.add(juce::String(note.isNoteOn ? "on " : "off ") + juce::String(note.pitch) + " at " + juce::String(note.sample));
+
+        return descriptions.joinIntoString(", ");
+    }
+};
+
+static PatternPlayerTests patternPlayerTests;
@@ -0,0 +1,90 @@
+#include <JuceHeader.h>
+#include "../Source/PatternState.h"
+
+//saves patterns and restores them into a fresh PatternModel, checking they come back cell for cell, including at the most
+//repeats a pattern can have
+class PatternStateTests : public juce::UnitTest
+{
+public:
+    PatternStateTests() : juce::UnitTest("PatternState round trip", "TiltSequencer") {}
+
+    void runTest() override
+    {
+        beginTest("Restores a pattern at the most repeats");
+        {
+            PatternModel pattern;
+            pattern.insertColumn(CONSTANTS::TICKS_PER_REPEAT / 2);
+            pattern.setRepeats(CONSTANTS::MAX_REPEATS);
+            writeNotes(pattern);
+
+            expectRestores(pattern);
+        }
+
+        beginTest("Clamps repeats past the most to the most, which restore");
+        {
+            PatternModel pattern;
+            pattern.setRepeats(CONSTANTS::MAX_REPEATS + 1);
+            expectEquals(pattern.getRepeats(), CONSTANTS::MAX_REPEATS);
+
+            writeNotes(pattern);
+            expectRestores(pattern);
+        }
+
+        beginTest("Restores the session");
+        {
+            PatternState::Session session;
+            session.referenceRow = 40;
+            session.visibleRows = 12;
+            session.tilt = 0.25f;
+            session.useDrumSampler = false;
+            session.morphColumns = false;
+
+            PatternState::Cache cache;
+            juce::MemoryBlock state;
+            PatternState::write(PatternModel(), session, cache, state);
+
+            PatternModel restored;
+            PatternState::Session restoredSession;
+            expect(PatternState::read(state.getData(), static_cast<int>(state.getSize()), restored, restoredSession));
+            expect(restoredSession == session);
+        }
+    }
+
+private:
+    //a note of one column at the start and a note of two columns wrapping around the end of the pattern
+    static void writeNotes(PatternModel& pattern)
+    {
+        const auto lastColumn{ pattern.columnsSize() - 1 };
+
+        pattern.setState(36, 0, true);
+        pattern.setState(38, lastColumn, true);
+        pattern.setIsRightConnected(38, lastColumn, true);
+        pattern.setState(38, 0, true);
+        pattern.setIsLeftConnected(38, 0, true);
+    }
+
+    void expectRestores(const PatternModel& pattern)
+    {
+        PatternState::Cache cache;
+        juce::MemoryBlock state;
+        PatternState::write(pattern, PatternState::Session{}, cache, state);
+
+        PatternModel restored;
+        PatternState::Session session;
+        expect(PatternState::read(state.getData(), static_cast<int>(state.getSize()), restored, session));
+
+        expectEquals(restored.getRepeats(), pattern.getRepeats());
+        expect(restored.getStartPositions() == pattern.getStartPositions());
+        expectEquals(restored.columnsSize(), pattern.columnsSize());
+
+        for (auto row{ 0 }; row != pattern.rowsSize(); ++row)
+            for (auto column{ 0 }; column != pattern.columnsSize(); ++column)
+                if (restored.getCell(row, column) != pattern.getCell(row, column))
+                {
+                    expect(false, "row " + juce::String(row) + " column " + juce::String(column) + " differs");
+                    return;
+                }
+    }
+};
+
+static PatternStateTests patternStateTests;